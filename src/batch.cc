@@ -0,0 +1,419 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_kernels.h"
+#include "s21_matrix_batch.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+constexpr std::size_t kAlignment = 64;
+constexpr int kLanes = S21BasicMatrixBatch<double>::kLanes;
+
+// Kernels over one group: every array holds kLanes interleaved matrices, so
+// element (i, j) of an n-column matrix starts at (i * n + j) * kLanes. They
+// are force-inlined into one copy per instruction set below, where the
+// fixed-length lane loops become vector instructions
+
+template <typename T>
+__attribute__((always_inline)) inline void LaneSubMul(
+    T* __restrict y, const T* __restrict f, const T* __restrict x) {
+  for (int l = 0; l < kLanes; ++l) y[l] -= f[l] * x[l];
+}
+
+template <typename T>
+__attribute__((always_inline)) inline void LaneInverse(
+    const T* __restrict pivot, T* __restrict inverse) {
+  // Zero pivots (singular matrices or unused lanes) give zero instead of a
+  // division by zero
+  for (int l = 0; l < kLanes; ++l)
+    inverse[l] = pivot[l] != T(0) ? T(1) / pivot[l] : T(0);
+}
+
+template <typename T>
+__attribute__((always_inline)) inline void MultiplyGroup(int m, int n, int k,
+                                                          const T* a,
+                                                          const T* b, T* c) {
+  // i-p-j order as in the small GEMM, with the lanes innermost
+  std::fill_n(c, static_cast<std::size_t>(m) * n * kLanes, T(0));
+  T minus_a[kLanes];
+  for (int i = 0; i < m; ++i)
+    for (int p = 0; p < k; ++p) {
+      const T* a_ip = a + (i * k + p) * kLanes;
+      for (int l = 0; l < kLanes; ++l) minus_a[l] = -a_ip[l];
+      for (int j = 0; j < n; ++j)
+        LaneSubMul(c + (i * n + j) * kLanes, minus_a, b + (p * n + j) * kLanes);
+    }
+}
+
+template <typename T>
+__attribute__((always_inline)) inline void EliminateGroup(int n, int m, T* a,
+                                                           T* b, T* det) {
+  // Gaussian elimination with partial pivoting, the same steps as
+  // S21BasicLU but with a pivot of its own in every lane. a (n x n) turns
+  // into U, the n x m right-hand sides b get the same row operations and det
+  // receives the determinant of every lane
+  for (int l = 0; l < kLanes; ++l) det[l] = T(1);
+  T pivots[kLanes], factor[kLanes], inverse[kLanes];
+  for (int k = 0; k < n; ++k) {
+    for (int l = 0; l < kLanes; ++l) {
+      int pivot = k;
+      auto max = std::abs(a[(k * n + k) * kLanes + l]);
+      for (int i = k + 1; i < n; ++i)
+        if (std::abs(a[(i * n + k) * kLanes + l]) > max) {
+          max = std::abs(a[(i * n + k) * kLanes + l]);
+          pivot = i;
+        }
+      if (pivot != k) {
+        T* a_k = a + k * n * kLanes + l;
+        T* a_p = a + pivot * n * kLanes + l;
+        for (int j = k; j < n; ++j) std::swap(a_k[j * kLanes], a_p[j * kLanes]);
+        T* b_k = b + k * m * kLanes + l;
+        T* b_p = b + pivot * m * kLanes + l;
+        for (int j = 0; j < m; ++j) std::swap(b_k[j * kLanes], b_p[j * kLanes]);
+        det[l] = -det[l];
+      }
+    }
+    const T* a_k = a + k * n * kLanes;
+    const T* b_k = b + k * m * kLanes;
+    for (int l = 0; l < kLanes; ++l) {
+      pivots[l] = a_k[k * kLanes + l];
+      det[l] *= pivots[l];
+    }
+    LaneInverse(pivots, inverse);
+    for (int i = k + 1; i < n; ++i) {
+      T* a_i = a + i * n * kLanes;
+      T* b_i = b + i * m * kLanes;
+      for (int l = 0; l < kLanes; ++l)
+        factor[l] = a_i[k * kLanes + l] * inverse[l];
+      for (int j = k + 1; j < n; ++j)
+        LaneSubMul(a_i + j * kLanes, factor, a_k + j * kLanes);
+      for (int j = 0; j < m; ++j)
+        LaneSubMul(b_i + j * kLanes, factor, b_k + j * kLanes);
+    }
+  }
+}
+
+template <typename T>
+__attribute__((always_inline)) inline void BackSubstituteGroup(int n, int m,
+                                                                const T* u,
+                                                                T* x) {
+  // Solves U * X = B in place of B, row by row from the bottom
+  T inverse[kLanes];
+  for (int i = n - 1; i >= 0; --i) {
+    const T* u_i = u + i * n * kLanes;
+    T* x_i = x + i * m * kLanes;
+    for (int p = i + 1; p < n; ++p)
+      for (int j = 0; j < m; ++j)
+        LaneSubMul(x_i + j * kLanes, u_i + p * kLanes,
+                   x + (p * m + j) * kLanes);
+    LaneInverse(u_i + i * kLanes, inverse);
+    for (int j = 0; j < m; ++j)
+      for (int l = 0; l < kLanes; ++l) x_i[j * kLanes + l] *= inverse[l];
+  }
+}
+
+template <typename T>
+struct GroupKernels {
+  void (*multiply)(int m, int n, int k, const T* a, const T* b, T* c);
+  void (*eliminate)(int n, int m, T* a, T* b, T* det);
+  void (*back_substitute)(int n, int m, const T* u, T* x);
+};
+
+template <typename T>
+void MultiplyGeneric(int m, int n, int k, const T* a, const T* b, T* c) {
+  MultiplyGroup(m, n, k, a, b, c);
+}
+
+template <typename T>
+void EliminateGeneric(int n, int m, T* a, T* b, T* det) {
+  EliminateGroup(n, m, a, b, det);
+}
+
+template <typename T>
+void BackSubstituteGeneric(int n, int m, const T* u, T* x) {
+  BackSubstituteGroup(n, m, u, x);
+}
+
+template <typename T>
+__attribute__((target("avx2,fma"))) void MultiplyAvx2(int m, int n, int k,
+                                                       const T* a, const T* b,
+                                                       T* c) {
+  MultiplyGroup(m, n, k, a, b, c);
+}
+
+template <typename T>
+__attribute__((target("avx2,fma"))) void EliminateAvx2(int n, int m, T* a,
+                                                        T* b, T* det) {
+  EliminateGroup(n, m, a, b, det);
+}
+
+template <typename T>
+__attribute__((target("avx2,fma"))) void BackSubstituteAvx2(int n, int m,
+                                                             const T* u,
+                                                             T* x) {
+  BackSubstituteGroup(n, m, u, x);
+}
+
+template <typename T>
+__attribute__((target("avx512f"))) void MultiplyAvx512(int m, int n, int k,
+                                                        const T* a, const T* b,
+                                                        T* c) {
+  MultiplyGroup(m, n, k, a, b, c);
+}
+
+template <typename T>
+__attribute__((target("avx512f"))) void EliminateAvx512(int n, int m, T* a,
+                                                         T* b, T* det) {
+  EliminateGroup(n, m, a, b, det);
+}
+
+template <typename T>
+__attribute__((target("avx512f"))) void BackSubstituteAvx512(int n, int m,
+                                                              const T* u,
+                                                              T* x) {
+  BackSubstituteGroup(n, m, u, x);
+}
+
+template <typename T>
+const GroupKernels<T>& Kernels() {
+  // Follows the level chosen for the S21Matrix kernels. Only float and
+  // double have wider copies, SSE2 is the baseline of the generic one
+  static const GroupKernels<T> generic = {
+      MultiplyGeneric<T>, EliminateGeneric<T>, BackSubstituteGeneric<T>};
+  static const GroupKernels<T> avx2 = {MultiplyAvx2<T>, EliminateAvx2<T>,
+                                       BackSubstituteAvx2<T>};
+  static const GroupKernels<T> avx512 = {
+      MultiplyAvx512<T>, EliminateAvx512<T>, BackSubstituteAvx512<T>};
+  if (!std::is_same<T, float>::value && !std::is_same<T, double>::value)
+    return generic;
+  switch (S21GetSimdLevel()) {
+    case S21SimdLevel::kAvx512:
+      return avx512;
+    case S21SimdLevel::kAvx2:
+      return avx2;
+    default:
+      return generic;
+  }
+}
+
+}  // namespace
+
+template <typename T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(int count, int rows, int cols)
+    : S21BasicMatrixBatch(count, rows, cols, S21GetResource()) {}
+
+template <typename T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(
+    int count, int rows, int cols, std::pmr::memory_resource* resource)
+    : count_(count),
+      rows_(rows),
+      cols_(cols),
+      p_(nullptr),
+      resource_(resource) {
+  // One zero-filled block holds the whole batch; the lanes of the last group
+  // past count stay zero matrices
+  if (count < 1 || rows < 1 || cols < 1)
+    throw CustomException("Count, rows and cols must be not less that 1");
+  std::size_t size = Groups() * GroupSize();
+  p_ = static_cast<T*>(resource_->allocate(size * sizeof(T), kAlignment));
+  std::fill_n(p_, size, T(0));
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(const S21BasicMatrixBatch& other)
+    : S21BasicMatrixBatch(other.count_, other.rows_, other.cols_) {
+  std::copy_n(other.p_, Groups() * GroupSize(), p_);
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(
+    S21BasicMatrixBatch&& other) noexcept
+    : count_(other.count_),
+      rows_(other.rows_),
+      cols_(other.cols_),
+      p_(other.p_),
+      resource_(other.resource_) {
+  other.count_ = 0;
+  other.p_ = nullptr;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>& S21BasicMatrixBatch<T>::operator=(
+    const S21BasicMatrixBatch& other) {
+  // The copy is made on the resource of this batch, which keeps it
+  if (this == &other) return *this;
+  S21BasicMatrixBatch copy(other.count_, other.rows_, other.cols_, resource_);
+  std::copy_n(other.p_, copy.Groups() * copy.GroupSize(), copy.p_);
+  return *this = std::move(copy);
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>& S21BasicMatrixBatch<T>::operator=(
+    S21BasicMatrixBatch&& other) {
+  // Takes the block of other when both resources are equal, otherwise copies
+  // it, so this batch never moves onto a resource that may go away first
+  if (this == &other) return *this;
+  if (!(*resource_ == *other.resource_)) return *this = other;
+  Release();
+  count_ = other.count_;
+  rows_ = other.rows_;
+  cols_ = other.cols_;
+  p_ = other.p_;
+  resource_ = other.resource_;
+  other.count_ = 0;
+  other.p_ = nullptr;
+  return *this;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T>::~S21BasicMatrixBatch() {
+  Release();
+}
+
+template <typename T>
+void S21BasicMatrixBatch<T>::Release() {
+  if (p_)
+    resource_->deallocate(p_, Groups() * GroupSize() * sizeof(T), kAlignment);
+  p_ = nullptr;
+}
+
+template <typename T>
+T& S21BasicMatrixBatch<T>::operator()(int index, int row, int col) {
+  if (index < 0 || index >= count_ || row < 0 || row >= rows_ || col < 0 ||
+      col >= cols_)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  return *Element(index, row, col);
+}
+
+template <typename T>
+const T& S21BasicMatrixBatch<T>::operator()(int index, int row,
+                                             int col) const {
+  return const_cast<S21BasicMatrixBatch&>(*this)(index, row, col);
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrixBatch<T>::Get(int index) const {
+  if (index < 0 || index >= count_)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  S21BasicMatrix<T> res(rows_, cols_);
+  for (int i = 0; i < rows_; ++i)
+    for (int j = 0; j < cols_; ++j) res(i, j) = *Element(index, i, j);
+  return res;
+}
+
+template <typename T>
+void S21BasicMatrixBatch<T>::Set(int index, const S21BasicMatrix<T>& matrix) {
+  if (index < 0 || index >= count_)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  if (matrix.get_rows() != rows_ || matrix.get_cols() != cols_)
+    throw CustomException("Different matrix dimensions");
+  for (int i = 0; i < rows_; ++i)
+    for (int j = 0; j < cols_; ++j) *Element(index, i, j) = matrix(i, j);
+}
+
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::Multiply(
+    const S21BasicMatrixBatch& other) const {
+  if (count_ != other.count_)
+    throw CustomException("Batches have different sizes");
+  if (cols_ != other.rows_)
+    throw CustomException(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  S21BasicMatrixBatch res(count_, rows_, other.cols_);
+  const GroupKernels<T>& kernels = Kernels<T>();
+  S21ThreadPool::Instance().ParallelFor(
+      Groups(), GroupSize() * other.cols_,
+      [&](std::size_t first, std::size_t last) {
+        for (int g = first; g < static_cast<int>(last); ++g)
+          kernels.multiply(rows_, other.cols_, cols_, Group(g),
+                           other.Group(g), res.Group(g));
+      });
+  return res;
+}
+
+template <typename T>
+std::vector<T> S21BasicMatrixBatch<T>::Determinant() const {
+  if (rows_ != cols_) throw CustomException("The matrix is not square");
+  std::vector<T> res(Groups() * kLanes);
+  const GroupKernels<T>& kernels = Kernels<T>();
+  S21ThreadPool::Instance().ParallelFor(
+      Groups(), GroupSize() * rows_, [&](std::size_t first, std::size_t last) {
+        thread_local std::vector<T> a;
+        a.resize(GroupSize());
+        for (int g = first; g < static_cast<int>(last); ++g) {
+          std::copy_n(Group(g), GroupSize(), a.data());
+          kernels.eliminate(rows_, 0, a.data(), nullptr,
+                            res.data() + g * kLanes);
+        }
+      });
+  res.resize(count_);
+  return res;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::Inverse() const {
+  // Every inverse is the solution for the identity as right-hand side. As
+  // S21Matrix::InverseMatrix() does, a determinant close to zero is an error
+  if (rows_ != cols_) throw CustomException("The matrix is not square");
+  S21BasicMatrixBatch res(count_, rows_, cols_);
+  for (int g = 0; g < Groups(); ++g)
+    for (int i = 0; i < rows_; ++i)
+      std::fill_n(res.Group(g) + (i * cols_ + i) * kLanes, kLanes, T(1));
+  const GroupKernels<T>& kernels = Kernels<T>();
+  S21ThreadPool::Instance().ParallelFor(
+      Groups(), GroupSize() * rows_ * 2,
+      [&](std::size_t first, std::size_t last) {
+        thread_local std::vector<T> a;
+        a.resize(GroupSize());
+        T det[kLanes];
+        for (int g = first; g < static_cast<int>(last); ++g) {
+          std::copy_n(Group(g), GroupSize(), a.data());
+          kernels.eliminate(rows_, cols_, a.data(), res.Group(g), det);
+          for (int l = 0; l < kLanes && g * kLanes + l < count_; ++l)
+            if (std::abs(det[l]) < 1e-7)
+              throw CustomException("Matrix determinant is 0");
+          kernels.back_substitute(rows_, cols_, a.data(), res.Group(g));
+        }
+      });
+  return res;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::Solve(
+    const S21BasicMatrixBatch& b) const {
+  if (rows_ != cols_) throw CustomException("The matrix is not square");
+  if (count_ != b.count_)
+    throw CustomException("Batches have different sizes");
+  if (b.rows_ != rows_)
+    throw CustomException(
+        "The number of rows of the right-hand side is not equal to the size "
+        "of the matrix");
+  S21BasicMatrixBatch res(b);
+  const GroupKernels<T>& kernels = Kernels<T>();
+  S21ThreadPool::Instance().ParallelFor(
+      Groups(), GroupSize() * (rows_ + b.cols_),
+      [&](std::size_t first, std::size_t last) {
+        thread_local std::vector<T> a;
+        a.resize(GroupSize());
+        T det[kLanes];
+        for (int g = first; g < static_cast<int>(last); ++g) {
+          std::copy_n(Group(g), GroupSize(), a.data());
+          kernels.eliminate(rows_, b.cols_, a.data(), res.Group(g), det);
+          for (int l = 0; l < kLanes && g * kLanes + l < count_; ++l)
+            if (det[l] == T(0)) throw CustomException("Matrix is singular");
+          kernels.back_substitute(rows_, b.cols_, a.data(), res.Group(g));
+        }
+      });
+  return res;
+}
+
+template class S21BasicMatrixBatch<float>;
+template class S21BasicMatrixBatch<double>;
+template class S21BasicMatrixBatch<long double>;
+template class S21BasicMatrixBatch<std::complex<double>>;
@@ -0,0 +1,626 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../s21_matrix_batch.h"
+#include "../s21_matrix_file.h"
+#include "../s21_matrix_graph.h"
+#include "../s21_matrix_oop.h"
+#include "../s21_memory.h"
+#include "../s21_solvers.h"
+#include "../s21_sparse_matrix.h"
+
+// Benchmarks of the main S21Matrix operations. Every case reports how many
+// bytes of matrix data it touched and, where it makes sense, its FLOP/s.
+// Run with --benchmark_format=json (or `make bench`) to get comparable runs
+
+namespace {
+
+S21Matrix MakeMatrix(int rows, int cols) {
+  // Well-conditioned matrix with a dominant diagonal, so Determinant() and
+  // InverseMatrix() never hit the singular branch
+  S21Matrix res(rows, cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      res(i, j) = i == j ? rows + 1.0 : ((i * 7 + j * 3) % 11) / 11.0;
+  return res;
+}
+
+void SetCounters(benchmark::State& state, double bytes, double flops) {
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+  if (flops > 0)
+    state.counters["FLOPS"] = benchmark::Counter(
+        state.iterations() * flops, benchmark::Counter::kIsRate);
+}
+
+double Bytes(int n, int matrices) {
+  return static_cast<double>(n) * n * sizeof(double) * matrices;
+}
+
+void BM_Construct(benchmark::State& state) {
+  int n = state.range(0);
+  for (auto _ : state) {
+    S21Matrix m(n, n);
+    benchmark::DoNotOptimize(m(0, 0));
+  }
+  SetCounters(state, Bytes(n, 1), 0);
+}
+BENCHMARK(BM_Construct)->RangeMultiplier(4)->Range(4, 1024);
+
+void BM_Copy(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix src = MakeMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix m(src);
+    benchmark::DoNotOptimize(m(0, 0));
+  }
+  SetCounters(state, Bytes(n, 2), 0);
+}
+BENCHMARK(BM_Copy)->RangeMultiplier(4)->Range(4, 1024);
+
+void BM_Move(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix src = MakeMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix m(std::move(src));
+    src = std::move(m);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_Move)->Arg(1024);
+
+// Summing every element through the checked operator(), the unchecked row
+// pointers and the iterators
+void BM_AccessChecked(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n);
+  for (auto _ : state) {
+    double sum = 0;
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j) sum += a(i, j);
+    benchmark::DoNotOptimize(sum);
+  }
+  SetCounters(state, Bytes(n, 1), 1.0 * n * n);
+}
+BENCHMARK(BM_AccessChecked)->Arg(64)->Arg(1024);
+
+void BM_AccessRows(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n);
+  for (auto _ : state) {
+    double sum = 0;
+    for (int i = 0; i < n; ++i) {
+      const double* row = a[i];
+      for (int j = 0; j < n; ++j) sum += row[j];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  SetCounters(state, Bytes(n, 1), 1.0 * n * n);
+}
+BENCHMARK(BM_AccessRows)->Arg(64)->Arg(1024);
+
+void BM_AccessIterators(benchmark::State& state) {
+  int n = state.range(0);
+  const S21Matrix a = MakeMatrix(n, n);
+  for (auto _ : state) {
+    double sum = 0;
+    for (double x : a) sum += x;
+    benchmark::DoNotOptimize(sum);
+  }
+  SetCounters(state, Bytes(n, 1), 1.0 * n * n);
+}
+BENCHMARK(BM_AccessIterators)->Arg(64)->Arg(1024);
+
+void BM_MulMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n), b = MakeMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetCounters(state, Bytes(n, 3), 2.0 * n * n * n);
+}
+BENCHMARK(BM_MulMatrix)
+    ->RangeMultiplier(2)
+    ->Range(8, 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+// Large products with the classic kernel (0) and Strassen-Winograd (1); the
+// FLOPS counter uses 2n^3 for both, so it shows the effective rate
+void BM_MulAlgorithm(benchmark::State& state) {
+  int n = state.range(0);
+  S21MulAlgorithm algorithm = state.range(1) ? S21MulAlgorithm::kStrassen
+                                             : S21MulAlgorithm::kClassic;
+  S21Matrix a = MakeMatrix(n, n), b = MakeMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix c = S21Matrix::Multiply(a, b, algorithm);
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetCounters(state, Bytes(n, 3), 2.0 * n * n * n);
+}
+BENCHMARK(BM_MulAlgorithm)
+    ->ArgsProduct({{1024, 2048}, {0, 1}})
+    ->ArgNames({"n", "strassen"})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_MulMatrixF(benchmark::State& state) {
+  int n = state.range(0);
+  S21MatrixF a(n, n), b(n, n);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j) a(i, j) = b(j, i) = (i + j) % 5 - 2.0f;
+  for (auto _ : state) {
+    S21MatrixF c = a * b;
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetCounters(state, 3.0 * n * n * sizeof(float), 2.0 * n * n * n);
+}
+BENCHMARK(BM_MulMatrixF)
+    ->RangeMultiplier(4)
+    ->Range(64, 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_Transpose(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix t = a.Transpose();
+    benchmark::DoNotOptimize(t(0, 0));
+  }
+  SetCounters(state, Bytes(n, 2), 0);
+}
+BENCHMARK(BM_Transpose)->RangeMultiplier(4)->Range(16, 4096);
+
+void BM_TransposeInPlace(benchmark::State& state) {
+  int rows = state.range(0), cols = state.range(1);
+  S21Matrix a = MakeMatrix(rows, cols);
+  for (auto _ : state) {
+    a.TransposeInPlace();
+    benchmark::ClobberMemory();
+  }
+  SetCounters(state, 2.0 * rows * cols * sizeof(double), 0);
+}
+BENCHMARK(BM_TransposeInPlace)
+    ->Args({256, 256})
+    ->Args({1024, 1024})
+    ->Args({4096, 4096})
+    ->Args({512, 2048});
+
+void BM_SumMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n), b = MakeMatrix(n, n);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  SetCounters(state, Bytes(n, 3), 1.0 * n * n);
+}
+BENCHMARK(BM_SumMatrix)->RangeMultiplier(4)->Range(16, 4096);
+
+void BM_MulNumber(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n);
+  for (auto _ : state) {
+    a.MulNumber(1.0000001);
+    benchmark::ClobberMemory();
+  }
+  SetCounters(state, Bytes(n, 2), 1.0 * n * n);
+}
+BENCHMARK(BM_MulNumber)->RangeMultiplier(4)->Range(16, 4096);
+
+void BM_EqMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n), b = MakeMatrix(n, n);
+  for (auto _ : state) benchmark::DoNotOptimize(a.EqMatrix(b));
+  SetCounters(state, Bytes(n, 2), 0);
+}
+BENCHMARK(BM_EqMatrix)->RangeMultiplier(4)->Range(16, 4096);
+
+void BM_ExpressionChain(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n), b = MakeMatrix(n, n), c = MakeMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix d = a + b - 2.0 * c;
+    benchmark::DoNotOptimize(d(0, 0));
+  }
+  SetCounters(state, Bytes(n, 4), 3.0 * n * n);
+}
+BENCHMARK(BM_ExpressionChain)->RangeMultiplier(4)->Range(16, 4096);
+
+void BM_Temporaries(benchmark::State& state) {
+  // Loop full of short-lived matrices of mixed sizes: the default resource
+  // (0), the size-class pool (1) and an arena per iteration (2)
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n), b = MakeMatrix(n, n);
+  S21PoolResource pool;
+  std::unique_ptr<S21ScopedResource> scope;
+  if (state.range(1) == 1) scope = std::make_unique<S21ScopedResource>(&pool);
+  for (auto _ : state) {
+    std::unique_ptr<S21ArenaScope> arena;
+    if (state.range(1) == 2) arena = std::make_unique<S21ArenaScope>();
+    S21Matrix c = a + b;
+    S21Matrix d = c.Transpose();
+    S21Matrix e(n + 1, n);
+    S21Matrix f = d.Block(0, 0, n / 2, n / 2);
+    benchmark::DoNotOptimize(f(0, 0));
+  }
+  SetCounters(state, Bytes(n, 7), 0);
+}
+BENCHMARK(BM_Temporaries)
+    ->ArgsProduct({{8, 64, 512}, {0, 1, 2}})
+    ->ArgNames({"n", "resource"});
+
+void BM_Determinant(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n);
+  for (auto _ : state) benchmark::DoNotOptimize(a.Determinant());
+  SetCounters(state, Bytes(n, 1), 2.0 / 3.0 * n * n * n);
+}
+BENCHMARK(BM_Determinant)
+    ->RangeMultiplier(4)
+    ->Range(4, 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_InverseMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix inv = a.InverseMatrix();
+    benchmark::DoNotOptimize(inv(0, 0));
+  }
+  SetCounters(state, Bytes(n, 2), 2.0 * n * n * n);
+}
+BENCHMARK(BM_InverseMatrix)
+    ->RangeMultiplier(4)
+    ->Range(4, 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+// Determinant() and InverseMatrix() of an unchanged matrix with caching
+// on: both are served from the cache filled before the loop, the inverse
+// only costs its copy
+void BM_DeterminantInverseCached(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n);
+  a.set_caching(true);
+  a.InverseMatrix();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.Determinant());
+    S21Matrix inv = a.InverseMatrix();
+    benchmark::DoNotOptimize(inv(0, 0));
+  }
+  SetCounters(state, Bytes(n, 2), 0);
+}
+BENCHMARK(BM_DeterminantInverseCached)
+    ->RangeMultiplier(4)
+    ->Range(4, 1024)
+    ->Unit(benchmark::kMicrosecond);
+
+// A * X = B with 16 right-hand sides: through the inverse, and factoring
+// once with LU, Cholesky (A is made symmetric) or QR
+constexpr int kRhs = 16;
+
+S21Matrix MakeSymmetric(int n) {
+  S21Matrix a = MakeMatrix(n, n);
+  return a + a.Transpose();
+}
+
+void BM_SolveInverse(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeSymmetric(n), b = MakeMatrix(n, kRhs);
+  for (auto _ : state) {
+    S21Matrix x = a.InverseMatrix() * b;
+    benchmark::DoNotOptimize(x(0, 0));
+  }
+  SetCounters(state, Bytes(n, 1), 2.0 * n * n * n);
+}
+BENCHMARK(BM_SolveInverse)->Arg(64)->Arg(256)->Arg(1024)->Unit(
+    benchmark::kMicrosecond);
+
+void BM_SolveLU(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeSymmetric(n), b = MakeMatrix(n, kRhs);
+  for (auto _ : state) {
+    S21Matrix x = S21LU(a).Solve(b);
+    benchmark::DoNotOptimize(x(0, 0));
+  }
+  SetCounters(state, Bytes(n, 1), 2.0 / 3.0 * n * n * n);
+}
+BENCHMARK(BM_SolveLU)->Arg(64)->Arg(256)->Arg(1024)->Unit(
+    benchmark::kMicrosecond);
+
+void BM_SolveMixed(benchmark::State& state) {
+  // Float LU plus double refinement; the label tells whether it had to
+  // fall back to the double factorization
+  int n = state.range(0);
+  S21Matrix a = MakeSymmetric(n), b = MakeMatrix(n, kRhs);
+  bool fallback = false;
+  for (auto _ : state) {
+    S21MixedLU mixed(a);
+    S21Matrix x = mixed.Solve(b);
+    benchmark::DoNotOptimize(x(0, 0));
+    fallback = mixed.UsedFallback();
+  }
+  state.SetLabel(fallback ? "fallback" : "refined");
+  SetCounters(state, Bytes(n, 1), 2.0 / 3.0 * n * n * n);
+}
+BENCHMARK(BM_SolveMixed)->Arg(64)->Arg(256)->Arg(1024)->Unit(
+    benchmark::kMicrosecond);
+
+void BM_SolveCholesky(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeSymmetric(n), b = MakeMatrix(n, kRhs);
+  for (auto _ : state) {
+    S21Matrix x = S21Cholesky(a).Solve(b);
+    benchmark::DoNotOptimize(x(0, 0));
+  }
+  SetCounters(state, Bytes(n, 1), 1.0 / 3.0 * n * n * n);
+}
+BENCHMARK(BM_SolveCholesky)->Arg(64)->Arg(256)->Arg(1024)->Unit(
+    benchmark::kMicrosecond);
+
+void BM_SolveQR(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeSymmetric(n), b = MakeMatrix(n, kRhs);
+  for (auto _ : state) {
+    S21Matrix x = S21QR(a).Solve(b);
+    benchmark::DoNotOptimize(x(0, 0));
+  }
+  SetCounters(state, Bytes(n, 1), 4.0 / 3.0 * n * n * n);
+}
+BENCHMARK(BM_SolveQR)->Arg(64)->Arg(256)->Arg(1024)->Unit(
+    benchmark::kMicrosecond);
+
+S21MatrixBatch MakeBatch(int count, int n) {
+  S21MatrixBatch res(count, n, n);
+  for (int k = 0; k < count; ++k)
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j)
+        res(k, i, j) = i == j ? n + 1.0 : ((k + i * 7 + j * 3) % 11) / 11.0;
+  return res;
+}
+
+// 10000 small matrices: one batched call (Batch) against a loop over
+// separate S21Matrix objects (Loop)
+constexpr int kBatchCount = 10000;
+
+void BM_BatchMultiply(benchmark::State& state) {
+  int n = state.range(0);
+  S21MatrixBatch a = MakeBatch(kBatchCount, n), b = MakeBatch(kBatchCount, n);
+  for (auto _ : state) {
+    S21MatrixBatch c = a.Multiply(b);
+    benchmark::DoNotOptimize(c(0, 0, 0));
+  }
+  SetCounters(state, Bytes(n, 3) * kBatchCount, 2.0 * n * n * n * kBatchCount);
+}
+BENCHMARK(BM_BatchMultiply)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+
+void BM_LoopMultiply(benchmark::State& state) {
+  int n = state.range(0);
+  S21MatrixBatch batch = MakeBatch(kBatchCount, n);
+  std::vector<S21Matrix> a, b;
+  for (int k = 0; k < kBatchCount; ++k) {
+    a.push_back(batch.Get(k));
+    b.push_back(batch.Get(k));
+  }
+  for (auto _ : state)
+    for (int k = 0; k < kBatchCount; ++k) {
+      S21Matrix c = a[k] * b[k];
+      benchmark::DoNotOptimize(c(0, 0));
+    }
+  SetCounters(state, Bytes(n, 3) * kBatchCount, 2.0 * n * n * n * kBatchCount);
+}
+BENCHMARK(BM_LoopMultiply)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+
+void BM_BatchInverse(benchmark::State& state) {
+  int n = state.range(0);
+  S21MatrixBatch a = MakeBatch(kBatchCount, n);
+  for (auto _ : state) {
+    S21MatrixBatch inv = a.Inverse();
+    benchmark::DoNotOptimize(inv(0, 0, 0));
+  }
+  SetCounters(state, Bytes(n, 2) * kBatchCount, 2.0 * n * n * n * kBatchCount);
+}
+BENCHMARK(BM_BatchInverse)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+
+void BM_LoopInverse(benchmark::State& state) {
+  int n = state.range(0);
+  S21MatrixBatch batch = MakeBatch(kBatchCount, n);
+  std::vector<S21Matrix> a;
+  for (int k = 0; k < kBatchCount; ++k) a.push_back(batch.Get(k));
+  for (auto _ : state)
+    for (int k = 0; k < kBatchCount; ++k) {
+      S21Matrix inv = a[k].InverseMatrix();
+      benchmark::DoNotOptimize(inv(0, 0));
+    }
+  SetCounters(state, Bytes(n, 2) * kBatchCount, 2.0 * n * n * n * kBatchCount);
+}
+BENCHMARK(BM_LoopInverse)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+
+void BM_BatchDeterminant(benchmark::State& state) {
+  int n = state.range(0);
+  S21MatrixBatch a = MakeBatch(kBatchCount, n);
+  for (auto _ : state) benchmark::DoNotOptimize(a.Determinant());
+  SetCounters(state, Bytes(n, 1) * kBatchCount,
+              2.0 / 3.0 * n * n * n * kBatchCount);
+}
+BENCHMARK(BM_BatchDeterminant)->Arg(4)->Arg(8)->Arg(16)->Arg(32);
+
+S21SparseMatrix MakeSparse(int n, int per_row) {
+  // Graph-like matrix with per_row entries in every row
+  std::vector<S21Triplet<double>> triplets;
+  for (int i = 0; i < n; ++i)
+    for (int k = 0; k < per_row; ++k)
+      triplets.push_back({i, static_cast<int>((i * 7919L + k * 104729L) % n),
+                          1.0 / (k + 1)});
+  return S21SparseMatrix(n, n, triplets);
+}
+
+void BM_SparseMultiplyVector(benchmark::State& state) {
+  int n = state.range(0);
+  S21SparseMatrix a = MakeSparse(n, 10);
+  std::vector<double> x(n, 1.0);
+  for (auto _ : state) {
+    std::vector<double> y = a * x;
+    benchmark::DoNotOptimize(y.data());
+  }
+  double nnz = a.get_nnz();
+  SetCounters(state, nnz * (sizeof(double) + sizeof(int)) + 3.0 * n * 8,
+              2 * nnz);
+}
+BENCHMARK(BM_SparseMultiplyVector)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+void BM_SparseMultiplyMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21SparseMatrix a = MakeSparse(n, 10);
+  S21Matrix b = MakeMatrix(n, 16);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(c(0, 0));
+  }
+  SetCounters(state, 2.0 * n * 16 * sizeof(double), 2.0 * a.get_nnz() * 16);
+}
+BENCHMARK(BM_SparseMultiplyMatrix)->Arg(1000)->Arg(100000);
+
+void BM_SparseConjugateGradient(benchmark::State& state) {
+  // 1-D Laplacian plus a shift, 16 right-hand sides advancing together
+  int n = state.range(0);
+  std::vector<S21Triplet<double>> triplets;
+  for (int i = 0; i < n; ++i) {
+    triplets.push_back({i, i, 2.5});
+    if (i > 0) triplets.push_back({i, i - 1, -1});
+    if (i + 1 < n) triplets.push_back({i, i + 1, -1});
+  }
+  S21SparseMatrix a(n, n, triplets);
+  S21Matrix b = MakeMatrix(n, kRhs);
+  for (auto _ : state) {
+    S21IterativeResult<double> res = S21ConjugateGradient(a, b);
+    benchmark::DoNotOptimize(res.x(0, 0));
+  }
+}
+BENCHMARK(BM_SparseConjugateGradient)->Arg(1000)->Arg(100000)->Unit(
+    benchmark::kMillisecond);
+
+// Save writes the whole file; Load reads it back into a new matrix and Map
+// only sets up the mapping, so its time does not grow with the matrix
+const char kBenchFile[] = "bench_matrix.bin";
+
+void BM_SaveMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n);
+  for (auto _ : state) S21SaveMatrix(kBenchFile, a);
+  std::remove(kBenchFile);
+  SetCounters(state, Bytes(n, 1), 0);
+}
+BENCHMARK(BM_SaveMatrix)->RangeMultiplier(8)->Range(64, 4096);
+
+void BM_LoadMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21SaveMatrix(kBenchFile, MakeMatrix(n, n));
+  for (auto _ : state) {
+    S21Matrix m = S21LoadMatrix<double>(kBenchFile);
+    benchmark::DoNotOptimize(m(0, 0));
+  }
+  std::remove(kBenchFile);
+  SetCounters(state, Bytes(n, 1), 0);
+}
+BENCHMARK(BM_LoadMatrix)->RangeMultiplier(8)->Range(64, 4096);
+
+void BM_MapMatrix(benchmark::State& state) {
+  int n = state.range(0);
+  S21SaveMatrix(kBenchFile, MakeMatrix(n, n));
+  for (auto _ : state) {
+    S21MappedMatrix m(kBenchFile);
+    benchmark::DoNotOptimize(m(n - 1, n - 1));
+  }
+  std::remove(kBenchFile);
+}
+BENCHMARK(BM_MapMatrix)->RangeMultiplier(8)->Range(64, 4096);
+
+// Out-of-core product with a budget of a quarter of one operand, compare
+// with BM_MulMatrix for the cost of streaming the tiles
+void BM_MultiplyFiles(benchmark::State& state) {
+  int n = state.range(0);
+  S21SaveMatrix("bench_a.bin", MakeMatrix(n, n));
+  S21SaveMatrix("bench_b.bin", MakeMatrix(n, n));
+  for (auto _ : state)
+    S21MultiplyFiles<double>("bench_a.bin", "bench_b.bin", "bench_c.bin",
+                             Bytes(n, 1) / 4);
+  std::remove("bench_a.bin");
+  std::remove("bench_b.bin");
+  std::remove("bench_c.bin");
+  SetCounters(state, Bytes(n, 3), 2.0 * n * n * n);
+}
+BENCHMARK(BM_MultiplyFiles)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+// Four independent inversions summed up, one after another on the calling
+// thread against one S21Async() DAG where they overlap
+constexpr int kDagBranches = 4;
+
+void BM_InverseDagSync(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix sum(n, n);
+    for (int k = 0; k < kDagBranches; ++k) sum += a.InverseMatrix();
+    benchmark::DoNotOptimize(sum(0, 0));
+  }
+  SetCounters(state, Bytes(n, 2), kDagBranches * 2.0 * n * n * n);
+}
+BENCHMARK(BM_InverseDagSync)->Arg(128)->Arg(512)->Unit(
+    benchmark::kMillisecond);
+
+void BM_InverseDagAsync(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n);
+  auto add = [](const S21Matrix& x, const S21Matrix& y) { return x + y; };
+  for (auto _ : state) {
+    S21Future<S21Matrix> inv[kDagBranches];
+    for (auto& f : inv) f = a.InverseMatrixAsync();
+    S21Matrix sum = S21Async(add, S21Async(add, inv[0], inv[1]),
+                             S21Async(add, inv[2], inv[3]))
+                        .Get();
+    benchmark::DoNotOptimize(sum(0, 0));
+  }
+  SetCounters(state, Bytes(n, 2), kDagBranches * 2.0 * n * n * n);
+}
+BENCHMARK(BM_InverseDagAsync)->Arg(128)->Arg(512)->Unit(
+    benchmark::kMillisecond);
+
+// a^T * b followed by the determinant and the inverse of the product,
+// eagerly against a fresh S21MatrixGraph, which reads a^T through a view
+// and factorizes the product once
+void BM_TransposeProductEager(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n), b = MakeMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix c = a.Transpose() * b;
+    benchmark::DoNotOptimize(c.Determinant());
+    S21Matrix inv = c.InverseMatrix();
+    benchmark::DoNotOptimize(inv(0, 0));
+  }
+  SetCounters(state, Bytes(n, 4), 2.0 * n * n * n + 8.0 / 3.0 * n * n * n);
+}
+BENCHMARK(BM_TransposeProductEager)->Arg(256)->Arg(1024)->Unit(
+    benchmark::kMillisecond);
+
+void BM_TransposeProductGraph(benchmark::State& state) {
+  int n = state.range(0);
+  S21Matrix a = MakeMatrix(n, n), b = MakeMatrix(n, n);
+  for (auto _ : state) {
+    S21MatrixGraph graph;
+    S21LazyMatrix c = graph.Input(a).Transpose() * graph.Input(b);
+    benchmark::DoNotOptimize(c.Determinant());
+    const S21Matrix& inv = c.InverseMatrix().Evaluate();
+    benchmark::DoNotOptimize(inv(0, 0));
+  }
+  SetCounters(state, Bytes(n, 4), 2.0 * n * n * n + 8.0 / 3.0 * n * n * n);
+}
+BENCHMARK(BM_TransposeProductGraph)->Arg(256)->Arg(1024)->Unit(
+    benchmark::kMillisecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
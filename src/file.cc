@@ -0,0 +1,528 @@
+#include "s21_matrix_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "s21_kernels.h"
+
+template <>
+struct S21MatrixFileType<float> {
+  static constexpr std::uint8_t kCode = 1;
+};
+template <>
+struct S21MatrixFileType<double> {
+  static constexpr std::uint8_t kCode = 2;
+};
+template <>
+struct S21MatrixFileType<long double> {
+  static constexpr std::uint8_t kCode = 3;
+};
+template <>
+struct S21MatrixFileType<std::complex<double>> {
+  static constexpr std::uint8_t kCode = 4;
+};
+
+namespace {
+
+constexpr std::uint64_t kDataOffset = 64;
+// Reads and writes are split into pieces of this size
+constexpr std::size_t kChunk = std::size_t(1) << 24;
+
+constexpr std::uint8_t NativeEndian() {
+  return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? 1 : 2;
+}
+
+void SwapBytes(void* p, std::size_t size) {
+  auto* bytes = static_cast<unsigned char*>(p);
+  std::reverse(bytes, bytes + size);
+}
+
+// Size in bytes of one scalar to byte-swap: a complex number is two doubles
+template <typename T>
+std::size_t ScalarSize() {
+  return sizeof(T);
+}
+template <>
+std::size_t ScalarSize<std::complex<double>>() {
+  return sizeof(double);
+}
+
+void WriteAll(int fd, const void* data, std::size_t size) {
+  const char* p = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t written = ::write(fd, p, std::min(size, kChunk));
+    if (written <= 0) throw CustomException("Cannot write matrix file");
+    p += written;
+    size -= written;
+  }
+}
+
+void WriteAll(int fd, const void* data, std::size_t size, off_t offset) {
+  const char* p = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t written = ::pwrite(fd, p, std::min(size, kChunk), offset);
+    if (written <= 0) throw CustomException("Cannot write matrix file");
+    p += written;
+    size -= written;
+    offset += written;
+  }
+}
+
+void ReadAll(int fd, void* data, std::size_t size, off_t offset) {
+  char* p = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t got = ::pread(fd, p, std::min(size, kChunk), offset);
+    if (got <= 0) throw CustomException("Matrix file is truncated");
+    p += got;
+    size -= got;
+    offset += got;
+  }
+}
+
+template <typename T>
+S21MatrixFileHeader ReadHeader(int fd) {
+  // Checks the header against T and returns it in the native byte order
+  S21MatrixFileHeader header;
+  ReadAll(fd, &header, sizeof(header), 0);
+  if (std::memcmp(header.magic, "S21M", 4) != 0)
+    throw CustomException("Not a matrix file");
+  if (header.endian != NativeEndian()) {
+    SwapBytes(&header.version, sizeof(header.version));
+    SwapBytes(&header.element_size, sizeof(header.element_size));
+    SwapBytes(&header.rows, sizeof(header.rows));
+    SwapBytes(&header.cols, sizeof(header.cols));
+    SwapBytes(&header.data_offset, sizeof(header.data_offset));
+  }
+  if (header.version != kS21MatrixFileVersion)
+    throw CustomException("Unsupported matrix file version");
+  if (header.dtype != S21MatrixFileType<T>::kCode ||
+      header.element_size != sizeof(T))
+    throw CustomException("Matrix file has another element type");
+  if (header.rows < 1 || header.cols < 1 || header.rows > INT32_MAX ||
+      header.cols > INT32_MAX)
+    throw CustomException("Matrix file has wrong dimensions");
+  return header;
+}
+
+template <typename T>
+S21MatrixFileHeader MakeHeader(int rows, int cols) {
+  S21MatrixFileHeader header = {};
+  std::memcpy(header.magic, "S21M", 4);
+  header.version = kS21MatrixFileVersion;
+  header.dtype = S21MatrixFileType<T>::kCode;
+  header.endian = NativeEndian();
+  header.element_size = sizeof(T);
+  header.rows = rows;
+  header.cols = cols;
+  header.data_offset = kDataOffset;
+  return header;
+}
+
+int OpenForReading(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) throw CustomException("Cannot open matrix file");
+  return fd;
+}
+
+// Closes a descriptor when the scope is left, also on exceptions
+class FileCloser {
+ public:
+  explicit FileCloser(int fd) : fd_(fd) {}
+  FileCloser(const FileCloser&) = delete;
+  FileCloser& operator=(const FileCloser&) = delete;
+  ~FileCloser() {
+    if (fd_ >= 0) ::close(fd_);
+  }
+
+ private:
+  int fd_;
+};
+
+// Row-major matrix stored in a file, accessed tile by tile
+struct TiledFile {
+  int fd;
+  int rows, cols;
+  off_t data_offset;
+};
+
+template <typename T>
+void ReadTile(const TiledFile& file, int row, int col, int rows, int cols,
+              T* dst) {
+  // One read per tile row, the rows land contiguously in dst
+  for (int i = 0; i < rows; ++i) {
+    off_t offset = file.data_offset +
+                   (static_cast<off_t>(row + i) * file.cols + col) * sizeof(T);
+    ReadAll(file.fd, dst + static_cast<std::size_t>(i) * cols,
+            cols * sizeof(T), offset);
+  }
+}
+
+template <typename T>
+void WriteTile(const TiledFile& file, int row, int col, int rows, int cols,
+               const T* src) {
+  for (int i = 0; i < rows; ++i) {
+    off_t offset = file.data_offset +
+                   (static_cast<off_t>(row + i) * file.cols + col) * sizeof(T);
+    WriteAll(file.fd, src + static_cast<std::size_t>(i) * cols,
+             cols * sizeof(T), offset);
+  }
+}
+
+template <typename T>
+TiledFile OpenTiled(int fd) {
+  // Tiles are read in place, so only files in the native byte order work
+  S21MatrixFileHeader header = ReadHeader<T>(fd);
+  if (header.endian != NativeEndian())
+    throw CustomException("Matrix file has another byte order");
+  return {fd, static_cast<int>(header.rows), static_cast<int>(header.cols),
+          static_cast<off_t>(header.data_offset)};
+}
+
+class StepReader {
+  // One I/O thread that runs load(t) for t = 0, 1, ..., count - 1 in order,
+  // so a long product does not start a thread per step. Step t is only
+  // loaded once the consumer has released step t - 2, which lets two sets
+  // of buffers alternate. It is not a pool task, because a worker blocked
+  // in pread would be missing from the multiplication
+ public:
+  StepReader(std::size_t count, std::function<void(std::size_t)> load)
+      : count_(count), load_(std::move(load)), thread_([this] { Run(); }) {}
+  StepReader(const StepReader&) = delete;
+  StepReader& operator=(const StepReader&) = delete;
+  ~StepReader() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  // Waits until step t is loaded, rethrows the error of a failed load
+  void Acquire(std::size_t t) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return error_ || loaded_ > t; });
+    if (error_) std::rethrow_exception(error_);
+  }
+  // The buffers of step t may be reused
+  void Release(std::size_t t) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      released_ = t + 1;
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  void Run() {
+    try {
+      for (std::size_t t = 0; t < count_; ++t) {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          cv_.wait(lock, [&] { return stop_ || released_ + 2 > t; });
+          if (stop_) return;
+        }
+        load_(t);
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          loaded_ = t + 1;
+        }
+        cv_.notify_all();
+      }
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_ = std::current_exception();
+      }
+      cv_.notify_all();
+    }
+  }
+
+  std::size_t count_;
+  std::function<void(std::size_t)> load_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::size_t loaded_ = 0, released_ = 0;
+  bool stop_ = false;
+  std::exception_ptr error_;
+  std::thread thread_;
+};
+
+}  // namespace
+
+template <typename T>
+S21BasicMatrixWriter<T>::S21BasicMatrixWriter(const std::string& path,
+                                              int rows, int cols)
+    : fd_(-1), rows_(rows), cols_(cols), rows_written_(0) {
+  if (rows < 1 || cols < 1)
+    throw CustomException("Rows and cols must be not less that 1");
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ < 0) throw CustomException("Cannot open matrix file");
+  S21MatrixFileHeader header = MakeHeader<T>(rows, cols);
+  try {
+    WriteAll(fd_, &header, sizeof(header));
+  } catch (...) {
+    ::close(fd_);
+    throw;
+  }
+}
+
+template <typename T>
+S21BasicMatrixWriter<T>::~S21BasicMatrixWriter() {
+  if (fd_ >= 0) ::close(fd_);
+}
+
+template <typename T>
+void S21BasicMatrixWriter<T>::WriteRows(const T* data, int count) {
+  if (fd_ < 0) throw CustomException("Matrix file is closed");
+  if (count < 0 || count > rows_ - rows_written_)
+    throw CustomException("Too many rows for the matrix file");
+  WriteAll(fd_, data, static_cast<std::size_t>(count) * cols_ * sizeof(T));
+  rows_written_ += count;
+}
+
+template <typename T>
+void S21BasicMatrixWriter<T>::WriteRows(
+    const S21BasicMatrixView<const T>& rows) {
+  // Rows with a unit column stride are written straight from the matrix,
+  // others are gathered first
+  if (rows.get_cols() != cols_)
+    throw CustomException("Different matrix dimensions");
+  if (rows.get_col_stride() == 1 && rows.get_row_stride() == cols_) {
+    WriteRows(rows.data(), rows.get_rows());
+    return;
+  }
+  std::vector<T> buffer(cols_);
+  for (int i = 0; i < rows.get_rows(); ++i) {
+    for (int j = 0; j < cols_; ++j) buffer[j] = rows(i, j);
+    WriteRows(buffer.data(), 1);
+  }
+}
+
+template <typename T>
+void S21BasicMatrixWriter<T>::Close() {
+  if (fd_ < 0) return;
+  int fd = fd_;
+  fd_ = -1;
+  if (::close(fd) != 0) throw CustomException("Cannot write matrix file");
+  if (rows_written_ != rows_)
+    throw CustomException("Not every row of the matrix file was written");
+}
+
+template <typename T>
+S21BasicMappedMatrix<T>::S21BasicMappedMatrix(const std::string& path)
+    : base_(nullptr), length_(0), data_(nullptr), rows_(0), cols_(0) {
+  int fd = OpenForReading(path);
+  try {
+    S21MatrixFileHeader header = ReadHeader<T>(fd);
+    if (header.endian != NativeEndian())
+      throw CustomException("Matrix file has another byte order");
+    struct stat st;
+    std::uint64_t end = header.data_offset +
+                        static_cast<std::uint64_t>(header.rows) * header.cols *
+                            sizeof(T);
+    if (::fstat(fd, &st) != 0 || static_cast<std::uint64_t>(st.st_size) < end)
+      throw CustomException("Matrix file is truncated");
+    if (header.data_offset % alignof(T) != 0)
+      throw CustomException("Matrix file data is misaligned");
+    // Read-only mapping, the pages stay shared with the page cache
+    void* base = ::mmap(nullptr, end, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) throw CustomException("Cannot map matrix file");
+    base_ = base;
+    length_ = end;
+    data_ = reinterpret_cast<T*>(static_cast<char*>(base) + header.data_offset);
+    rows_ = header.rows;
+    cols_ = header.cols;
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+}
+
+template <typename T>
+S21BasicMappedMatrix<T>::~S21BasicMappedMatrix() {
+  if (base_) ::munmap(base_, length_);
+}
+
+template <typename T>
+const T& S21BasicMappedMatrix<T>::operator()(int row, int col) const {
+  if (row >= rows_ || col >= cols_ || col < 0 || row < 0)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  return data_[static_cast<std::size_t>(row) * cols_ + col];
+}
+
+template <typename T>
+S21BasicMatrixView<const T> S21BasicMappedMatrix<T>::View() const {
+  return S21BasicMatrixView<const T>(data_, rows_, cols_, cols_, 1);
+}
+
+template <typename T>
+void S21SaveMatrix(const std::string& path, const S21BasicMatrix<T>& m) {
+  S21SaveMatrix(path, S21BasicMatrixView<const T>(m));
+}
+
+template <typename T>
+void S21SaveMatrix(const std::string& path,
+                   const S21BasicMatrixView<const T>& m) {
+  S21BasicMatrixWriter<T> writer(path, m.get_rows(), m.get_cols());
+  writer.WriteRows(m);
+  writer.Close();
+}
+
+template <typename T>
+S21BasicMatrix<T> S21LoadMatrix(const std::string& path) {
+  int fd = OpenForReading(path);
+  try {
+    S21MatrixFileHeader header = ReadHeader<T>(fd);
+    S21BasicMatrix<T> res(header.rows, header.cols);
+    std::size_t size = static_cast<std::size_t>(header.rows) * header.cols;
+    ReadAll(fd, res.data(), size * sizeof(T), header.data_offset);
+    if (header.endian != NativeEndian()) {
+      std::size_t scalar = ScalarSize<T>();
+      char* bytes = reinterpret_cast<char*>(res.data());
+      for (std::size_t i = 0; i < size * sizeof(T); i += scalar)
+        SwapBytes(bytes + i, scalar);
+    }
+    ::close(fd);
+    return res;
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+}
+
+template <typename T>
+void S21MultiplyFiles(const std::string& a_path, const std::string& b_path,
+                      const std::string& c_path, std::size_t memory_budget) {
+  // C is computed one t x t tile at a time: the tile is accumulated over the
+  // t x t tiles of A's row band and B's column band, then written out with
+  // pwrite. While S21Gemm works on the current pair of input tiles, the next
+  // pair is read by a StepReader into a second set of buffers. Five tiles
+  // (two pairs plus C) fit the budget
+  int a_fd = OpenForReading(a_path);
+  FileCloser a_closer(a_fd);
+  int b_fd = OpenForReading(b_path);
+  FileCloser b_closer(b_fd);
+  TiledFile a = OpenTiled<T>(a_fd), b = OpenTiled<T>(b_fd);
+  if (a.cols != b.rows)
+    throw CustomException(
+        "The number of columns of the first matrix is not equal to the number "
+        "of rows of the second matrix");
+  std::size_t side = std::sqrt(memory_budget / (5.0 * sizeof(T)));
+  if (side < 1) throw CustomException("Memory budget is too small");
+  int m = a.rows, n = b.cols, k = a.cols;
+  int tm = std::min<std::size_t>(side, m), tn = std::min<std::size_t>(side, n),
+      tk = std::min<std::size_t>(side, k);
+
+  // Truncating an operand would destroy it before it is read, so the output
+  // must be another file than both (under any name or link)
+  struct stat c_st;
+  if (::stat(c_path.c_str(), &c_st) == 0) {
+    for (int fd : {a_fd, b_fd}) {
+      struct stat st;
+      if (::fstat(fd, &st) != 0)
+        throw CustomException("Cannot read matrix file");
+      if (st.st_dev == c_st.st_dev && st.st_ino == c_st.st_ino)
+        throw CustomException("The product cannot overwrite an operand");
+    }
+  }
+  int c_fd =
+      ::open(c_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (c_fd < 0) throw CustomException("Cannot open matrix file");
+  FileCloser c_closer(c_fd);
+  S21MatrixFileHeader header = MakeHeader<T>(m, n);
+  WriteAll(c_fd, &header, sizeof(header), 0);
+  if (::ftruncate(c_fd, kDataOffset + static_cast<std::uint64_t>(m) * n *
+                                          sizeof(T)) != 0)
+    throw CustomException("Cannot write matrix file");
+  TiledFile c = {c_fd, m, n, static_cast<off_t>(kDataOffset)};
+
+  // Steps in the order they are computed: (row band, column band, k block)
+  struct Step {
+    int i, j, p;
+  };
+  std::vector<Step> steps;
+  for (int i = 0; i < m; i += tm)
+    for (int j = 0; j < n; j += tn)
+      for (int p = 0; p < k; p += tk) steps.push_back({i, j, p});
+
+  std::vector<T> a_tiles[2], b_tiles[2];
+  for (int s = 0; s < 2; ++s) {
+    a_tiles[s].resize(static_cast<std::size_t>(tm) * tk);
+    b_tiles[s].resize(static_cast<std::size_t>(tk) * tn);
+  }
+  std::vector<T> c_tile(static_cast<std::size_t>(tm) * tn);
+  auto load = [&](const Step& step, int s) {
+    ReadTile(a, step.i, step.p, std::min(tm, m - step.i),
+             std::min(tk, k - step.p), a_tiles[s].data());
+    ReadTile(b, step.p, step.j, std::min(tk, k - step.p),
+             std::min(tn, n - step.j), b_tiles[s].data());
+  };
+  StepReader reader(steps.size(),
+                    [&](std::size_t t) { load(steps[t], t % 2); });
+  for (std::size_t s = 0; s < steps.size(); ++s) {
+    const Step& step = steps[s];
+    int cur = s % 2;
+    reader.Acquire(s);
+    int rows = std::min(tm, m - step.i), cols = std::min(tn, n - step.j),
+        depth = std::min(tk, k - step.p);
+    S21Gemm(rows, cols, depth, a_tiles[cur].data(), depth, 1,
+            b_tiles[cur].data(), cols, 1, c_tile.data(), cols, step.p > 0);
+    reader.Release(s);
+    if (step.p + depth == k)
+      WriteTile(c, step.i, step.j, rows, cols, c_tile.data());
+  }
+}
+
+template class S21BasicMatrixWriter<float>;
+template class S21BasicMatrixWriter<double>;
+template class S21BasicMatrixWriter<long double>;
+template class S21BasicMatrixWriter<std::complex<double>>;
+template class S21BasicMappedMatrix<float>;
+template class S21BasicMappedMatrix<double>;
+template class S21BasicMappedMatrix<long double>;
+template class S21BasicMappedMatrix<std::complex<double>>;
+template void S21SaveMatrix(const std::string&, const S21BasicMatrix<float>&);
+template void S21SaveMatrix(const std::string&, const S21BasicMatrix<double>&);
+template void S21SaveMatrix(const std::string&,
+                            const S21BasicMatrix<long double>&);
+template void S21SaveMatrix(const std::string&,
+                            const S21BasicMatrix<std::complex<double>>&);
+template void S21SaveMatrix<float>(const std::string&,
+                                   const S21BasicMatrixView<const float>&);
+template void S21SaveMatrix<double>(const std::string&,
+                                    const S21BasicMatrixView<const double>&);
+template void S21SaveMatrix<long double>(
+    const std::string&, const S21BasicMatrixView<const long double>&);
+template void S21SaveMatrix<std::complex<double>>(
+    const std::string&, const S21BasicMatrixView<const std::complex<double>>&);
+template S21BasicMatrix<float> S21LoadMatrix(const std::string&);
+template S21BasicMatrix<double> S21LoadMatrix(const std::string&);
+template S21BasicMatrix<long double> S21LoadMatrix(const std::string&);
+template S21BasicMatrix<std::complex<double>> S21LoadMatrix(
+    const std::string&);
+template void S21MultiplyFiles<float>(const std::string&, const std::string&,
+                                       const std::string&, std::size_t);
+template void S21MultiplyFiles<double>(const std::string&, const std::string&,
+                                        const std::string&, std::size_t);
+template void S21MultiplyFiles<long double>(const std::string&,
+                                             const std::string&,
+                                             const std::string&, std::size_t);
+template void S21MultiplyFiles<std::complex<double>>(const std::string&,
+                                                      const std::string&,
+                                                      const std::string&,
+                                                      std::size_t);
@@ -0,0 +1,132 @@
+#include "s21_kernels.h"
+
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Blocking parameters: an MR x NR block of C stays in registers, a KC x NR
+// sliver of B stays in L1, an MC x KC panel of A stays in L2 and a KC x NC
+// panel of B stays in L3
+constexpr int kMr = kS21GemmMr;
+constexpr int kNr = kS21GemmNr;
+constexpr int kKc = 256;
+constexpr int kMc = 96;
+constexpr int kNc = 2048;
+
+using Complex = std::complex<double>;
+
+// Products smaller than this (m * n * k) are not worth packing
+constexpr long kSmallProduct = 32 * 32 * 32;
+
+template <typename T>
+void PackA(int mc, int kc, const T* a, std::ptrdiff_t rsa,
+           std::ptrdiff_t csa, T* buf) {
+  // Copies an mc x kc block of A into MR-row slivers, each stored column by
+  // column, so the micro-kernel reads it sequentially. Short slivers are
+  // padded with zeroes
+  for (int i = 0; i < mc; i += kMr) {
+    int mr = std::min(kMr, mc - i);
+    for (int p = 0; p < kc; ++p) {
+      const T* src = a + i * rsa + p * csa;
+      int ii = 0;
+      for (; ii < mr; ++ii) *buf++ = src[ii * rsa];
+      for (; ii < kMr; ++ii) *buf++ = T(0);
+    }
+  }
+}
+
+template <typename T>
+void PackB(int kc, int nc, const T* b, std::ptrdiff_t rsb,
+           std::ptrdiff_t csb, T* buf) {
+  // Copies a kc x nc block of B into NR-column slivers, each stored row by row
+  for (int j = 0; j < nc; j += kNr) {
+    int nr = std::min(kNr, nc - j);
+    for (int p = 0; p < kc; ++p) {
+      const T* src = b + p * rsb + j * csb;
+      int jj = 0;
+      for (; jj < nr; ++jj) *buf++ = src[jj * csb];
+      for (; jj < kNr; ++jj) *buf++ = T(0);
+    }
+  }
+}
+
+template <typename T>
+void SmallGemm(int m, int n, int k, const T* a, std::ptrdiff_t rsa,
+               std::ptrdiff_t csa, const T* b, std::ptrdiff_t rsb,
+               std::ptrdiff_t csb, T* c, std::ptrdiff_t ldc, bool accumulate) {
+  // i-k-j order: the innermost loop runs along a row of C
+  for (int i = 0; i < m; ++i) {
+    T* c_row = c + i * ldc;
+    if (!accumulate) std::fill(c_row, c_row + n, T(0));
+    for (int p = 0; p < k; ++p) {
+      T a_ip = a[i * rsa + p * csa];
+      const T* b_row = b + p * rsb;
+      for (int j = 0; j < n; ++j) c_row[j] += a_ip * b_row[j * csb];
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void S21Gemm(int m, int n, int k, const T* a, std::ptrdiff_t rsa,
+             std::ptrdiff_t csa, const T* b, std::ptrdiff_t rsb,
+             std::ptrdiff_t csb, T* c, std::ptrdiff_t ldc, bool accumulate) {
+  // Goto/BLIS-style loop nest around the register micro-kernel, which is
+  // picked for the running CPU
+  if (static_cast<long>(m) * n * k <= kSmallProduct) {
+    SmallGemm(m, n, k, a, rsa, csa, b, rsb, csb, c, ldc, accumulate);
+    return;
+  }
+  // Packing buffers are reused between calls made by the same thread. The
+  // B panel is packed once and shared, then MC-row blocks of A are spread
+  // over the thread pool, each thread packing its own A block
+  thread_local std::vector<T> b_buf;
+  b_buf.resize(static_cast<std::size_t>(kKc) *
+               ((std::min(n, kNc) + kNr - 1) / kNr * kNr));
+  auto micro_kernel = S21Kernels<T>().micro_kernel;
+  int m_blocks = (m + kMc - 1) / kMc;
+  for (int jc = 0; jc < n; jc += kNc) {
+    int nc = std::min(kNc, n - jc);
+    for (int pc = 0; pc < k; pc += kKc) {
+      int kc = std::min(kKc, k - pc);
+      bool acc = accumulate || pc > 0;
+      const T* b_packed = b_buf.data();
+      PackB(kc, nc, b + pc * rsb + jc * csb, rsb, csb, b_buf.data());
+      S21ThreadPool::Instance().ParallelFor(
+          m_blocks, static_cast<std::size_t>(kMc) * kc * nc,
+          [&](std::size_t first, std::size_t last) {
+            thread_local std::vector<T> a_buf;
+            a_buf.resize(static_cast<std::size_t>(kMc) * kKc);
+            for (int ic = static_cast<int>(first) * kMc;
+                 ic < static_cast<int>(last) * kMc && ic < m; ic += kMc) {
+              int mc = std::min(kMc, m - ic);
+              PackA(mc, kc, a + ic * rsa + pc * csa, rsa, csa, a_buf.data());
+              for (int jr = 0; jr < nc; jr += kNr)
+                for (int ir = 0; ir < mc; ir += kMr)
+                  micro_kernel(kc, a_buf.data() + ir * kc, b_packed + jr * kc,
+                               c + (ic + ir) * ldc + jc + jr, ldc,
+                               std::min(kMr, mc - ir), std::min(kNr, nc - jr),
+                               acc);
+            }
+          });
+    }
+  }
+}
+
+template void S21Gemm(int, int, int, const float*, std::ptrdiff_t,
+                      std::ptrdiff_t, const float*, std::ptrdiff_t,
+                      std::ptrdiff_t, float*, std::ptrdiff_t, bool);
+template void S21Gemm(int, int, int, const double*, std::ptrdiff_t,
+                      std::ptrdiff_t, const double*, std::ptrdiff_t,
+                      std::ptrdiff_t, double*, std::ptrdiff_t, bool);
+template void S21Gemm(int, int, int, const long double*, std::ptrdiff_t,
+                      std::ptrdiff_t, const long double*, std::ptrdiff_t,
+                      std::ptrdiff_t, long double*, std::ptrdiff_t, bool);
+template void S21Gemm(int, int, int, const Complex*, std::ptrdiff_t,
+                      std::ptrdiff_t, const Complex*, std::ptrdiff_t,
+                      std::ptrdiff_t, Complex*, std::ptrdiff_t, bool);
@@ -0,0 +1,236 @@
+#include "s21_matrix_graph.h"
+
+#include <complex>
+#include <functional>
+#include <utility>
+
+#include "s21_kernels.h"
+
+template <typename T>
+int S21BasicLazyMatrix<T>::get_rows() const {
+  return graph_->nodes_[id_].rows;
+}
+
+template <typename T>
+int S21BasicLazyMatrix<T>::get_cols() const {
+  return graph_->nodes_[id_].cols;
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicLazyMatrix<T>::operator+(
+    const S21BasicLazyMatrix& other) const {
+  return graph_->Binary(S21BasicMatrixGraph<T>::Kind::kAdd, *this, other);
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicLazyMatrix<T>::operator-(
+    const S21BasicLazyMatrix& other) const {
+  return graph_->Binary(S21BasicMatrixGraph<T>::Kind::kSub, *this, other);
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicLazyMatrix<T>::operator*(
+    const S21BasicLazyMatrix& other) const {
+  return graph_->Binary(S21BasicMatrixGraph<T>::Kind::kMul, *this, other);
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicLazyMatrix<T>::operator*(const T num) const {
+  return graph_->Scale(id_, num);
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicLazyMatrix<T>::Transpose() const {
+  return graph_->Transpose(id_);
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicLazyMatrix<T>::InverseMatrix() const {
+  return graph_->Inverse(id_);
+}
+
+template <typename T>
+const S21BasicMatrix<T>& S21BasicLazyMatrix<T>::Evaluate() const {
+  return graph_->Evaluate(id_);
+}
+
+template <typename T>
+T S21BasicLazyMatrix<T>::Determinant() const {
+  return graph_->Determinant(id_);
+}
+
+template <typename T>
+bool S21BasicMatrixGraph<T>::Key::operator==(const Key& other) const {
+  return kind == other.kind && lhs == other.lhs && rhs == other.rhs &&
+         scalar == other.scalar && input == other.input;
+}
+
+template <typename T>
+std::size_t S21BasicMatrixGraph<T>::KeyHash::operator()(
+    const Key& key) const {
+  // Boost-style combination of the fields; the scalar goes in through its
+  // real and imaginary parts, which also covers std::complex
+  using Real = decltype(std::real(key.scalar));
+  std::size_t hash = static_cast<std::size_t>(key.kind);
+  auto mix = [&hash](std::size_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+  };
+  mix(std::hash<int>()(key.lhs));
+  mix(std::hash<int>()(key.rhs));
+  mix(std::hash<Real>()(std::real(key.scalar)));
+  mix(std::hash<Real>()(std::imag(key.scalar)));
+  mix(std::hash<const void*>()(key.input));
+  return hash;
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicMatrixGraph<T>::Intern(const Key& key, int rows,
+                                                     int cols) {
+  auto it = index_.find(key);
+  if (it != index_.end()) return {this, it->second};
+  int id = static_cast<int>(nodes_.size());
+  nodes_.push_back({key, rows, cols, nullptr, nullptr});
+  index_.emplace(key, id);
+  return {this, id};
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicMatrixGraph<T>::Input(
+    const S21BasicMatrix<T>& matrix) {
+  return Intern({Kind::kInput, -1, -1, T(0), &matrix}, matrix.get_rows(),
+                matrix.get_cols());
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicMatrixGraph<T>::Binary(
+    Kind kind, const S21BasicLazyMatrix<T>& x, const S21BasicLazyMatrix<T>& y) {
+  // Ids only mean something within their own graph
+  if (x.graph_ != this || y.graph_ != this)
+    throw CustomException("Matrices belong to different graphs");
+  int lhs = x.id_, rhs = y.id_;
+  const Node &a = nodes_[lhs], &b = nodes_[rhs];
+  if (kind == Kind::kMul) {
+    if (a.cols != b.rows)
+      throw CustomException(
+          "The number of columns of the first matrix is not equal to the "
+          "number of rows of the second matrix");
+    return Intern({kind, lhs, rhs, T(0), nullptr}, a.rows, b.cols);
+  }
+  if (a.rows != b.rows || a.cols != b.cols)
+    throw CustomException("Different matrix dimensions");
+  // Sums are commutative, their operands are kept in id order
+  if (kind == Kind::kAdd && lhs > rhs) std::swap(lhs, rhs);
+  return Intern({kind, lhs, rhs, T(0), nullptr}, a.rows, a.cols);
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicMatrixGraph<T>::Scale(int id, T num) {
+  if (num == T(1)) return {this, id};
+  return Intern({Kind::kScale, id, -1, num, nullptr}, nodes_[id].rows,
+                nodes_[id].cols);
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicMatrixGraph<T>::Transpose(int id) {
+  if (nodes_[id].key.kind == Kind::kTranspose)
+    return {this, nodes_[id].key.lhs};
+  return Intern({Kind::kTranspose, id, -1, T(0), nullptr}, nodes_[id].cols,
+                nodes_[id].rows);
+}
+
+template <typename T>
+S21BasicLazyMatrix<T> S21BasicMatrixGraph<T>::Inverse(int id) {
+  if (nodes_[id].rows != nodes_[id].cols)
+    throw CustomException("The matrix is not square");
+  return Intern({Kind::kInverse, id, -1, T(0), nullptr}, nodes_[id].rows,
+                nodes_[id].cols);
+}
+
+template <typename T>
+void S21BasicMatrixGraph<T>::Invalidate() {
+  for (Node& node : nodes_) {
+    node.value.reset();
+    node.lu.reset();
+  }
+}
+
+template <typename T>
+S21BasicMatrixView<const T> S21BasicMatrixGraph<T>::Operand(int id) {
+  const Node& node = nodes_[id];
+  if (node.key.kind != Kind::kTranspose || node.value)
+    return S21BasicMatrixView<const T>(Evaluate(id));
+  const S21BasicMatrix<T>& m = Evaluate(node.key.lhs);
+  return {m.data(), m.get_cols(), m.get_rows(), 1, m.get_cols()};
+}
+
+template <typename T>
+const S21BasicMatrix<T>& S21BasicMatrixGraph<T>::Evaluate(int id) {
+  // Operands are computed depth first. Evaluation never adds nodes, so
+  // references into nodes_ stay valid through the recursion
+  const Key& key = nodes_[id].key;
+  if (key.kind == Kind::kInput) {
+    if (key.input->get_rows() != nodes_[id].rows ||
+        key.input->get_cols() != nodes_[id].cols)
+      throw CustomException("Graph input has changed its size");
+    return *key.input;
+  }
+  if (nodes_[id].value) return *nodes_[id].value;
+  auto compute = [&]() -> S21BasicMatrix<T> {
+    switch (key.kind) {
+      case Kind::kAdd:
+        return Operand(key.lhs) + Operand(key.rhs);
+      case Kind::kSub:
+        return Operand(key.lhs) - Operand(key.rhs);
+      case Kind::kScale:
+        return Operand(key.lhs) * key.scalar;
+      case Kind::kMul:
+        return S21BasicMatrix<T>::Multiply(Operand(key.lhs),
+                                           Operand(key.rhs));
+      case Kind::kTranspose: {
+        const S21BasicMatrix<T>& m = Evaluate(key.lhs);
+        S21BasicMatrix<T> res(m.get_cols(), m.get_rows());
+        S21Transpose(m.get_rows(), m.get_cols(), m.data(), m.get_cols(),
+                     res.data(), res.get_cols());
+        return res;
+      }
+      default: {
+        // Inverse, with the same rule as S21BasicMatrix::InverseMatrix()
+        const S21BasicLU<T>& lu = Factor(key.lhs);
+        if (std::abs(lu.Determinant()) < 1e-7)
+          throw CustomException("Matrix determinant is 0");
+        return lu.Inverse();
+      }
+    }
+  };
+  nodes_[id].value = std::make_unique<S21BasicMatrix<T>>(compute());
+  ++computed_;
+  return *nodes_[id].value;
+}
+
+template <typename T>
+const S21BasicLU<T>& S21BasicMatrixGraph<T>::Factor(int id) {
+  if (!nodes_[id].lu) {
+    auto lu = std::make_unique<S21BasicLU<T>>(Evaluate(id));
+    ++computed_;
+    nodes_[id].lu = std::move(lu);
+  }
+  return *nodes_[id].lu;
+}
+
+template <typename T>
+T S21BasicMatrixGraph<T>::Determinant(int id) {
+  // det(A^T) = det(A), so a transpose is never computed for it
+  if (nodes_[id].rows != nodes_[id].cols)
+    throw CustomException("The matrix is not square");
+  while (nodes_[id].key.kind == Kind::kTranspose) id = nodes_[id].key.lhs;
+  return Factor(id).Determinant();
+}
+
+template class S21BasicLazyMatrix<float>;
+template class S21BasicLazyMatrix<double>;
+template class S21BasicLazyMatrix<long double>;
+template class S21BasicLazyMatrix<std::complex<double>>;
+template class S21BasicMatrixGraph<float>;
+template class S21BasicMatrixGraph<double>;
+template class S21BasicMatrixGraph<long double>;
+template class S21BasicMatrixGraph<std::complex<double>>;
@@ -0,0 +1,230 @@
+#include "s21_instrument.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+constexpr const char* kOpNames[] = {"Construct", "Copy", "MulMatrix",
+                                    "InverseMatrix", "Determinant"};
+static_assert(sizeof(kOpNames) / sizeof(kOpNames[0]) ==
+                  static_cast<int>(S21Op::kCount),
+              "Every operation needs a name");
+
+constexpr std::memory_order kRelaxed = std::memory_order_relaxed;
+
+// Cache-miss counter of the current thread, opened on first use after perf
+// events have been enabled. -1 means the kernel refused it
+class PerfCounter {
+ public:
+  ~PerfCounter() {
+#ifdef __linux__
+    if (fd_ >= 0) ::close(fd_);
+#endif
+  }
+
+  bool Open() {
+#ifdef __linux__
+    if (fd_ == kUnopened) {
+      perf_event_attr attr = {};
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = PERF_COUNT_HW_CACHE_MISSES;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fd_ = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1,
+                                       PERF_FLAG_FD_CLOEXEC));
+      if (fd_ < 0) fd_ = -1;
+    }
+#endif
+    return fd_ >= 0;
+  }
+
+  std::uint64_t Read() {
+    std::uint64_t value = 0;
+#ifdef __linux__
+    if (Open() && ::read(fd_, &value, sizeof(value)) != sizeof(value))
+      value = 0;
+#endif
+    return value;
+  }
+
+ private:
+  static constexpr int kUnopened = -2;
+  int fd_ = kUnopened;
+};
+
+thread_local PerfCounter perf_counter;
+
+}  // namespace
+
+S21Instrument& S21Instrument::Instance() {
+  static S21Instrument instrument;
+  return instrument;
+}
+
+bool S21Instrument::IsCompiledIn() {
+#ifdef S21_MATRIX_INSTRUMENT
+  return true;
+#else
+  return false;
+#endif
+}
+
+S21Instrument::S21Instrument() : perf_events_(false) { Reset(); }
+
+int S21Instrument::Bucket(std::uint64_t ns) {
+  // Values below 8 get a bucket each, then every power of two is split into
+  // four buckets by the two bits after the leading one
+  if (ns < 8) return static_cast<int>(ns);
+  int msb = 63 - __builtin_clzll(ns);
+  return 8 + (msb - 3) * 4 + static_cast<int>((ns >> (msb - 2)) & 3);
+}
+
+std::uint64_t S21Instrument::BucketLimit(int bucket) {
+  if (bucket < 8) return bucket;
+  int msb = (bucket - 8) / 4 + 3, sub = (bucket - 8) % 4;
+  std::uint64_t width = std::uint64_t(1) << (msb - 2);
+  return (4 + sub) * width + width - 1;
+}
+
+void S21Instrument::Record(S21Op op, std::uint64_t ns, std::uint64_t bytes,
+                           std::uint64_t flops, std::uint64_t cache_misses) {
+  Counters& counters = counters_[static_cast<int>(op)];
+  counters.calls.fetch_add(1, kRelaxed);
+  counters.total_ns.fetch_add(ns, kRelaxed);
+  counters.bytes.fetch_add(bytes, kRelaxed);
+  counters.flops.fetch_add(flops, kRelaxed);
+  counters.cache_misses.fetch_add(cache_misses, kRelaxed);
+  counters.histogram[Bucket(ns)].fetch_add(1, kRelaxed);
+}
+
+void S21Instrument::Reset() {
+  for (Counters& counters : counters_) {
+    counters.calls = 0;
+    counters.total_ns = 0;
+    counters.bytes = 0;
+    counters.flops = 0;
+    counters.cache_misses = 0;
+    for (auto& bucket : counters.histogram) bucket = 0;
+  }
+}
+
+std::uint64_t S21Instrument::Percentile(const Counters& counters,
+                                        std::uint64_t calls, double q) const {
+  if (calls == 0) return 0;
+  std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(q * calls));
+  std::uint64_t seen = 0;
+  for (int b = 0; b < kBuckets; ++b) {
+    seen += counters.histogram[b].load(kRelaxed);
+    if (seen >= rank) return BucketLimit(b);
+  }
+  return BucketLimit(kBuckets - 1);
+}
+
+std::vector<S21OpStats> S21Instrument::Snapshot() const {
+  // Counters keep moving while they are read, so a snapshot taken under
+  // load is consistent per field, not across fields
+  std::vector<S21OpStats> res;
+  for (int i = 0; i < static_cast<int>(S21Op::kCount); ++i) {
+    const Counters& counters = counters_[i];
+    std::uint64_t calls = counters.calls.load(kRelaxed);
+    res.push_back({kOpNames[i], calls, counters.total_ns.load(kRelaxed),
+                   Percentile(counters, calls, 0.5),
+                   Percentile(counters, calls, 0.9),
+                   Percentile(counters, calls, 0.99),
+                   counters.bytes.load(kRelaxed), counters.flops.load(kRelaxed),
+                   counters.cache_misses.load(kRelaxed)});
+  }
+  return res;
+}
+
+std::string S21Instrument::ToJson() const {
+  std::ostringstream out;
+  out << "{\"compiled_in\":" << (IsCompiledIn() ? "true" : "false")
+      << ",\"perf_events\":" << (get_perf_events() ? "true" : "false")
+      << ",\"operations\":[";
+  bool first = true;
+  for (const S21OpStats& s : Snapshot()) {
+    out << (first ? "" : ",") << "{\"name\":\"" << s.name
+        << "\",\"calls\":" << s.calls << ",\"total_ns\":" << s.total_ns
+        << ",\"p50_ns\":" << s.p50_ns << ",\"p90_ns\":" << s.p90_ns
+        << ",\"p99_ns\":" << s.p99_ns << ",\"bytes\":" << s.bytes
+        << ",\"flops\":" << s.flops << ",\"cache_misses\":" << s.cache_misses
+        << "}";
+    first = false;
+  }
+  out << "]}";
+  return out.str();
+}
+
+std::string S21Instrument::ToPrometheus() const {
+  std::vector<S21OpStats> stats = Snapshot();
+  std::ostringstream out;
+  auto counter = [&](const char* metric, const char* help,
+                     std::uint64_t S21OpStats::*field) {
+    out << "# HELP " << metric << ' ' << help << "\n# TYPE " << metric
+        << " counter\n";
+    for (const S21OpStats& s : stats)
+      out << metric << "{op=\"" << s.name << "\"} " << s.*field << '\n';
+  };
+  counter("s21_matrix_calls_total", "Calls of S21Matrix operations.",
+          &S21OpStats::calls);
+  counter("s21_matrix_bytes_total", "Bytes allocated by the operations.",
+          &S21OpStats::bytes);
+  counter("s21_matrix_flops_total", "Floating-point operations performed.",
+          &S21OpStats::flops);
+  counter("s21_matrix_cache_misses_total",
+          "Cache misses counted by perf events.", &S21OpStats::cache_misses);
+  out << "# HELP s21_matrix_latency_seconds Latency of the operations.\n"
+         "# TYPE s21_matrix_latency_seconds summary\n";
+  for (const S21OpStats& s : stats) {
+    const std::pair<const char*, std::uint64_t> quantiles[] = {
+        {"0.5", s.p50_ns}, {"0.9", s.p90_ns}, {"0.99", s.p99_ns}};
+    for (const auto& q : quantiles)
+      out << "s21_matrix_latency_seconds{op=\"" << s.name << "\",quantile=\""
+          << q.first << "\"} " << q.second * 1e-9 << '\n';
+    out << "s21_matrix_latency_seconds_sum{op=\"" << s.name << "\"} "
+        << s.total_ns * 1e-9 << '\n'
+        << "s21_matrix_latency_seconds_count{op=\"" << s.name << "\"} "
+        << s.calls << '\n';
+  }
+  return out.str();
+}
+
+bool S21Instrument::EnablePerfEvents(bool enable) {
+  // The counter of the calling thread is opened right away to find out
+  // whether the kernel allows it (see perf_event_paranoid); other threads
+  // open theirs on their first instrumented operation
+  if (enable && !perf_counter.Open()) enable = false;
+  perf_events_ = enable;
+  return enable;
+}
+
+std::uint64_t S21Instrument::ReadCacheMisses() const {
+  return perf_events_.load(kRelaxed) ? perf_counter.Read() : 0;
+}
+
+S21OpTimer::S21OpTimer(S21Op op, std::uint64_t bytes, double flops)
+    : op_(op),
+      bytes_(bytes),
+      flops_(static_cast<std::uint64_t>(flops)),
+      cache_misses_(S21Instrument::Instance().ReadCacheMisses()),
+      start_(std::chrono::steady_clock::now()) {}
+
+S21OpTimer::~S21OpTimer() {
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_)
+                .count();
+  S21Instrument& instrument = S21Instrument::Instance();
+  std::uint64_t misses = instrument.ReadCacheMisses();
+  instrument.Record(op_, ns, bytes_, flops_,
+                    misses > cache_misses_ ? misses - cache_misses_ : 0);
+}
@@ -0,0 +1,119 @@
+#include "s21_matrix_oop.h"
+
+#include <algorithm>
+#include <complex>
+#include <utility>
+
+#include "s21_thread_pool.h"
+
+template <typename T>
+S21BasicLU<T>::S21BasicLU(const S21BasicMatrix<T>& matrix)
+    : lu_(matrix), perm_(matrix.rows_), sign_(1), singular_(false) {
+  // Right-looking Doolittle elimination: for every column the row with the
+  // largest absolute value becomes the pivot, then the rows below are updated.
+  // All updates run along contiguous rows of the row-major storage
+  if (matrix.rows_ != matrix.cols_)
+    throw CustomException("The matrix is not square");
+  int n = lu_.rows_;
+  for (int i = 0; i < n; ++i) perm_[i] = i;
+  for (int k = 0; k < n; ++k) {
+    int pivot = k;
+    auto max = std::abs(lu_.RowPtr(k)[k]);
+    for (int i = k + 1; i < n; ++i)
+      if (std::abs(lu_.RowPtr(i)[k]) > max) {
+        max = std::abs(lu_.RowPtr(i)[k]);
+        pivot = i;
+      }
+    if (max == 0) {
+      // The whole column is zero, there is nothing to eliminate
+      singular_ = true;
+      continue;
+    }
+    if (pivot != k) {
+      T* a = lu_.RowPtr(k);
+      T* b = lu_.RowPtr(pivot);
+      for (int j = 0; j < n; ++j) std::swap(a[j], b[j]);
+      std::swap(perm_[k], perm_[pivot]);
+      sign_ = -sign_;
+    }
+    // Rows below the pivot are independent, big trailing updates are split
+    // over the thread pool
+    const T* row_k = lu_.RowPtr(k);
+    S21ThreadPool::Instance().ParallelFor(
+        n - k - 1, n - k, [&](std::size_t first, std::size_t last) {
+          for (int i = k + 1 + first; i < k + 1 + static_cast<int>(last); ++i) {
+            T* row_i = lu_.RowPtr(i);
+            T l = row_i[k] / row_k[k];
+            row_i[k] = l;
+            if (l != T(0))
+              for (int j = k + 1; j < n; ++j) row_i[j] -= l * row_k[j];
+          }
+        });
+  }
+}
+
+template <typename T>
+T S21BasicLU<T>::Determinant() const {
+  // The determinant of a triangular matrix is the product of its diagonal,
+  // the permutation only contributes its sign
+  if (singular_) return 0;
+  T res(sign_);
+  for (int i = 0; i < lu_.rows_; ++i) res *= lu_.RowPtr(i)[i];
+  return res;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicLU<T>::Solve(const S21BasicMatrix<T>& b) const {
+  // Forward substitution with L and backward substitution with U, done for
+  // all right-hand sides at once by operating on whole rows of X
+  if (b.rows_ != lu_.rows_)
+    throw CustomException(
+        "The number of rows of the right-hand side is not equal to the size "
+        "of the matrix");
+  if (singular_) throw CustomException("Matrix is singular");
+  int n = lu_.rows_, m = b.cols_;
+  S21BasicMatrix<T> x(n, m);
+  for (int i = 0; i < n; ++i)
+    std::copy_n(b.RowPtr(perm_[i]), m, x.RowPtr(i));
+  // Right-hand sides are independent, so column ranges of X are solved in
+  // parallel
+  S21ThreadPool::Instance().ParallelFor(
+      m, static_cast<std::size_t>(n) * n,
+      [&](std::size_t first, std::size_t last) {
+        int j0 = first, j1 = last;
+        for (int i = 0; i < n; ++i) {
+          const T* l = lu_.RowPtr(i);
+          T* x_i = x.RowPtr(i);
+          for (int k = 0; k < i; ++k) {
+            const T* x_k = x.RowPtr(k);
+            if (l[k] != T(0))
+              for (int j = j0; j < j1; ++j) x_i[j] -= l[k] * x_k[j];
+          }
+        }
+        for (int i = n - 1; i >= 0; --i) {
+          const T* u = lu_.RowPtr(i);
+          T* x_i = x.RowPtr(i);
+          for (int k = i + 1; k < n; ++k) {
+            const T* x_k = x.RowPtr(k);
+            if (u[k] != T(0))
+              for (int j = j0; j < j1; ++j) x_i[j] -= u[k] * x_k[j];
+          }
+          for (int j = j0; j < j1; ++j) x_i[j] /= u[i];
+        }
+      });
+  return x;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicLU<T>::Inverse() const {
+  // The inverse is the solution for the identity matrix as right-hand side
+  int n = lu_.rows_;
+  S21BasicMatrix<T> identity(n, n);
+  for (int i = 0; i < n; ++i) identity.RowPtr(i)[i] = T(1);
+  return Solve(identity);
+}
+
+template class S21BasicLU<float>;
+template class S21BasicLU<double>;
+template class S21BasicLU<long double>;
+template class S21BasicLU<std::complex<double>>;
@@ -1,33 +1,107 @@
 #include "s21_matrix_oop.h"
 
-S21Matrix::S21Matrix() {
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include "s21_instrument.h"
+#include "s21_kernels.h"
+#include "s21_thread_pool.h"
+
+template <typename T>
+T* S21BasicMatrix<T>::Allocate(int rows, int cols, bool zero) const {
+  // Allocates one aligned zero-filled block for the whole matrix from
+  // resource_, so a matrix of any size costs a single trip to the allocator.
+  // Blocks that are about to be overwritten completely may skip the zeroing
+  std::size_t size = static_cast<std::size_t>(rows) * cols;
+  T* p = static_cast<T*>(resource_->allocate(size * sizeof(T), kAlignment));
+  if (zero) std::fill_n(p, size, T(0));
+  return p;
+}
+
+template <typename T>
+void S21BasicMatrix<T>::Deallocate(T* p, std::size_t size) const {
+  if (p) resource_->deallocate(p, size * sizeof(T), kAlignment);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::Swap(S21BasicMatrix& other) {
+  std::swap(rows_, other.rows_);
+  std::swap(cols_, other.cols_);
+  std::swap(p_, other.p_);
+  std::swap(resource_, other.resource_);
+  InvalidateCache();
+  other.InvalidateCache();
+}
+
+namespace {
+
+// Runs an element-wise kernel over [0, size) in chunks on the thread pool
+template <typename Body>
+void ForEachChunk(std::size_t size, Body body) {
+  S21ThreadPool::Instance().ParallelFor(
+      size, 1, [&body](std::size_t begin, std::size_t end) {
+        body(begin, end - begin);
+      });
+}
+
+// Copy handed to an asynchronous task. It is taken from the default
+// resource, since the one current here may be an arena released before the
+// task runs
+template <typename T>
+S21BasicMatrix<T> Detach(const S21BasicMatrix<T>& m) {
+  S21BasicMatrix<T> res(m.get_rows(), m.get_cols(),
+                        std::pmr::get_default_resource());
+  std::copy(m.begin(), m.end(), res.begin());
+  return res;
+}
+
+}  // namespace
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix() {
   // Default constructor creates 3x3 zero-matrix
+  S21_INSTRUMENT(S21Op::kConstruct, 9 * sizeof(T), 0);
   rows_ = 3;
   cols_ = 3;
-  p_ = new double*[rows_];
-  for (int i = 0; i < rows_; ++i) p_[i] = new double[cols_]();
+  resource_ = S21GetResource();
+  p_ = Allocate(rows_, cols_);
 }
 
-S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols)
+    : S21BasicMatrix(rows, cols, S21GetResource()) {}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols,
+                                  std::pmr::memory_resource* resource)
+    : rows_(rows), cols_(cols), resource_(resource) {
   // This constructor creates rowsxcols zero-matrix
   // Note: rows_(rows) is a shortcut instead of rows_ = rows; in a separate line
   if (rows > 0 && cols > 0) {
-    p_ = new double*[rows_];
-    for (int i = 0; i < rows_; ++i) p_[i] = new double[cols_]();
+    S21_INSTRUMENT(S21Op::kConstruct, Size() * sizeof(T), 0);
+    p_ = Allocate(rows_, cols_);
   } else {
     throw CustomException("Rows and cols must be not less that 1");
   }
 }
 
-S21Matrix::S21Matrix(const S21Matrix& other)
-    : S21Matrix::S21Matrix(other.rows_, other.cols_) {
-  // This constructor creates a copy of a given matrix
-  // Note: ":" syntax in this case invokes other member-function
-  for (int i = 0; i < rows_; ++i)
-    for (int j = 0; j < cols_; ++j) p_[i][j] = other.p_[i][j];
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(const S21BasicMatrix& other)
+    : rows_(other.rows_), cols_(other.cols_), resource_(S21GetResource()) {
+  // This constructor creates a copy of a given matrix. The block is filled
+  // by the copy, so it is not zeroed first
+  S21_INSTRUMENT(S21Op::kCopy, Size() * sizeof(T), 0);
+  p_ = Allocate(rows_, cols_, false);
+  std::copy_n(other.p_, Size(), p_);
 }
 
-S21Matrix::S21Matrix(S21Matrix&& other) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(S21BasicMatrix&& other) noexcept {
   // This constructor moves given matrix to this one
   // Note: this constructor invokes by compilator's decision when an other
   // object is about to be destroyed (e.g. when returning an object out of
@@ -35,116 +109,138 @@ S21Matrix::S21Matrix(S21Matrix&& other) {
   rows_ = other.rows_;
   cols_ = other.cols_;
   p_ = other.p_;
+  resource_ = other.resource_;
+  cache_ = std::move(other.cache_);
   other.rows_ = 0;
   other.cols_ = 0;
   other.p_ = nullptr;
 }
 
-S21Matrix::~S21Matrix() {
+template <typename T>
+S21BasicMatrix<T>::~S21BasicMatrix() {
   // Destructor just deallocates memory of p_
-  if (p_) {
-    for (int i = 0; i < rows_; ++i) delete[] p_[i];
-    delete[] p_;
-  }
+  Deallocate(p_, Size());
 }
 
-void S21Matrix::set_rows(int rows) {
+template <typename T>
+void S21BasicMatrix<T>::set_rows(int rows) {
   // This mutator changes the rows_ value and reallocate p_ (if rows > rows_,
-  // new matrix values will be filled with zeroes)
+  // new matrix values will be filled with zeroes). Rows are stored one after
+  // another, so the kept ones are copied in a single pass
   if (rows < 1) throw CustomException("Rows cant be less than 1");
-  if (rows < rows_) {
-    for (int i = rows; i < rows_; ++i) delete[] p_[i];
-  } else if (rows > rows_) {
-    double** p = new double*[rows];
-    for (int i = 0; i < rows; ++i) {
-      p[i] = new double[cols_]();
-      if (i < rows_)
-        for (int j = 0; j < cols_; ++j) p[i][j] = p_[i][j];
-    }
-    this->~S21Matrix();
+  if (rows != rows_) {
+    InvalidateCache();
+    T* p = Allocate(rows, cols_);
+    int kept = rows < rows_ ? rows : rows_;
+    std::copy_n(p_, static_cast<std::size_t>(kept) * cols_, p);
+    Deallocate(p_, Size());
     p_ = p;
+    rows_ = rows;
   }
-  rows_ = rows;
 }
 
-void S21Matrix::set_cols(int cols) {
-  // Similar to set_rows()
+template <typename T>
+void S21BasicMatrix<T>::set_cols(int cols) {
+  // Similar to set_rows(), but the row stride changes, so every row is copied
+  // to its new place separately
   if (cols < 1) throw CustomException("Columns cant be less than 1");
   if (cols != cols_) {
-    for (int i = 0; i < rows_; ++i) {
-      double* pi = new double[cols]();
-      for (int j = 0; j < cols; ++j)
-        if (j < cols_) pi[j] = p_[i][j];
-      delete[] p_[i];
-      p_[i] = pi;
-    }
+    InvalidateCache();
+    T* p = Allocate(rows_, cols);
+    int kept = cols < cols_ ? cols : cols_;
+    for (int i = 0; i < rows_; ++i)
+      std::copy_n(RowPtr(i), kept, p + static_cast<std::size_t>(i) * cols);
+    Deallocate(p_, Size());
+    p_ = p;
     cols_ = cols;
   }
 }
 
-bool S21Matrix::EqMatrix(const S21Matrix& other) {
+template <typename T>
+bool S21BasicMatrix<T>::EqMatrix(const S21BasicMatrix& other) {
   // This function returns true if cols, rows and matrix values of both matrixes
   // are equal, false otherwise
-  bool res = true;
-  if (rows_ != other.rows_ || cols_ != other.cols_) res = false;
-  for (int i = 0; i < rows_ && res; ++i)
-    for (int j = 0; j < cols_ && res; ++j)
-      if (fabs(p_[i][j] - other.p_[i][j]) > 1e-7) res = false;
+  if (rows_ != other.rows_ || cols_ != other.cols_) return false;
+  std::atomic<bool> res(true);
+  ForEachChunk(Size(), [&](std::size_t begin, std::size_t count) {
+    if (res.load(std::memory_order_relaxed) &&
+        !S21Kernels<T>().equal(p_ + begin, other.p_ + begin, count, 1e-7))
+      res = false;
+  });
   return res;
 }
 
-void S21Matrix::SumMatrix(const S21Matrix& other) {
+template <typename T>
+void S21BasicMatrix<T>::SumMatrix(const S21BasicMatrix& other) {
   // This function simply adds other matrix to this
   if (rows_ != other.rows_ || cols_ != other.cols_)
     throw CustomException("Different matrix dimensions");
-  for (int i = 0; i < rows_; ++i)
-    for (int j = 0; j < cols_; ++j) p_[i][j] += other.p_[i][j];
+  InvalidateCache();
+  ForEachChunk(Size(), [&](std::size_t begin, std::size_t count) {
+    S21Kernels<T>().add(p_ + begin, other.p_ + begin, count);
+  });
 }
 
-void S21Matrix::SubMatrix(const S21Matrix& other) {
+template <typename T>
+void S21BasicMatrix<T>::SubMatrix(const S21BasicMatrix& other) {
   // This function simply subs other matrix from this
   if (rows_ != other.rows_ || cols_ != other.cols_)
     throw CustomException("Different matrix dimensions");
-  for (int i = 0; i < rows_; ++i)
-    for (int j = 0; j < cols_; ++j) p_[i][j] -= other.p_[i][j];
+  InvalidateCache();
+  ForEachChunk(Size(), [&](std::size_t begin, std::size_t count) {
+    S21Kernels<T>().sub(p_ + begin, other.p_ + begin, count);
+  });
 }
 
-void S21Matrix::MulNumber(const double num) {
+template <typename T>
+void S21BasicMatrix<T>::MulNumber(const T num) {
   // This function simply multiplies matrix values by number
-  for (int i = 0; i < rows_; ++i)
-    for (int j = 0; j < cols_; ++j) p_[i][j] *= num;
+  InvalidateCache();
+  ForEachChunk(Size(), [&](std::size_t begin, std::size_t count) {
+    S21Kernels<T>().scale(p_ + begin, num, count);
+  });
 }
 
-void S21Matrix::MulMatrix(const S21Matrix& other) {
-  // This function multiplies this matrix by other, and sets a proper size to
-  // this
-  if (cols_ != other.rows_)
-    throw CustomException(
-        "The number of columns of the first matrix is not equal to the "
-        "number of rows of the second matrix");
-  S21Matrix this_copy(*this);
-  this->set_cols(other.cols_);
-  for (int i = 0; i < rows_; ++i)
-    for (int j = 0; j < cols_; ++j) {
-      double sum = 0;
-      for (int k = 0; k < this_copy.cols_; ++k)
-        sum += this_copy.p_[i][k] * other.p_[k][j];
-      p_[i][j] = sum;
-    }
+template <typename T>
+void S21BasicMatrix<T>::MulMatrix(const S21BasicMatrixView<const T>& other) {
+  // This function multiplies this matrix by other (a matrix or a view), and
+  // sets a proper size to this. The product is built in a fresh buffer that
+  // then replaces p_, so other may be a view into this matrix. The buffer
+  // comes from resource_, so the matrix keeps its own resource whatever
+  // scope is current
+  S21ScopedResource scope(resource_);
+  S21BasicMatrix res = Multiply(*this, other);
+  Swap(res);
 }
 
-S21Matrix S21Matrix::Transpose() {
-  // This function return trasposed version of this matrix
-  S21Matrix res(cols_, rows_);
-  for (int i = 0; i < rows_; ++i)
-    for (int j = 0; j < cols_; ++j) res.p_[j][i] = p_[i][j];
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Transpose() {
+  // This function return trasposed version of this matrix. The copy goes
+  // block by block, so both matrices are read and written in cache-sized
+  // pieces instead of striding down whole columns
+  S21BasicMatrix res(cols_, rows_);
+  S21Transpose(rows_, cols_, p_, cols_, res.p_, res.cols_);
   return res;
 }
 
-S21Matrix S21Matrix::HandleMatrix(int ex_i, int ex_j) {
+template <typename T>
+void S21BasicMatrix<T>::TransposeInPlace() {
+  // This function transposes this matrix without allocating a second one.
+  // Square matrices swap tiles across the diagonal, rectangular ones move
+  // every element along the cycles of the transposition permutation
+  InvalidateCache();
+  if (rows_ == cols_)
+    S21TransposeInPlace(rows_, p_, cols_);
+  else
+    S21TransposeInPlace(rows_, cols_, p_);
+  std::swap(rows_, cols_);
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::HandleMatrix(int ex_i, int ex_j) {
   // Little function to create a minor matrix from a given one by excluding
   // certain row and col
-  S21Matrix res(rows_ - 1, cols_ - 1);
+  S21BasicMatrix res(rows_ - 1, cols_ - 1);
   for (int i = 0, i_b = 0; i < rows_; ++i, ++i_b) {
     if (i == ex_i) {
       --i_b;
@@ -155,128 +251,237 @@ S21Matrix S21Matrix::HandleMatrix(int ex_i, int ex_j) {
         --j_b;
         continue;
       }
-      res.p_[i_b][j_b] = p_[i][j];
+      res.RowPtr(i_b)[j_b] = RowPtr(i)[j];
     }
   }
   return res;
 }
 
-S21Matrix S21Matrix::CalcComplements() {
-  // This function returns a matrix of algebraic complements of this matrix
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::CalcComplements() {
+  // This function returns a matrix of algebraic complements of this matrix.
+  // For a non-singular matrix the complements are the transposed adjugate,
+  // and adj(A) = det(A) * A^-1, so one LU factorization gives all of them.
+  // Tiny and singular matrices get their minors computed one by one instead
+  // (for n <= 3 the minors are at most 2x2, which is cheaper and exact)
   if (rows_ != cols_) throw CustomException("The matrix is not square");
   if (rows_ == 1) return *this;
-  S21Matrix res(rows_, cols_);
-  for (int i = 0; i < rows_; ++i)
-    for (int j = 0; j < cols_; ++j) {
-      S21Matrix sub_matrix = this->HandleMatrix(i, j);  // sub_matrix is a minor
-      if (sub_matrix.rows_ == 2) {
-        res.p_[i][j] = ((i + j) % 2 ? -1 : 1) * sub_matrix.TwoDet();
-      } else if (sub_matrix.rows_ == 1) {
-        res.p_[i][j] = ((i + j) % 2 ? -1 : 1) * sub_matrix.OneDet();
-      } else {
-        S21Matrix recursive =
-            sub_matrix.CalcComplements();  // this is a recursive algorithm
-        for (int k = 0; k < sub_matrix.rows_; ++k)
-          res.p_[i][j] += sub_matrix.p_[0][k] * recursive.p_[0][k];
-        if ((i + j) % 2) res.p_[i][j] *= -1;
-      }
+  if (rows_ > 3) {
+    std::optional<S21BasicLU<T>> local;
+    const S21BasicLU<T>& lu = Factorize(local);
+    if (!lu.IsSingular()) {
+      S21BasicMatrix res = lu.Inverse().Transpose();
+      res.MulNumber(lu.Determinant());
+      return res;
     }
+  }
+  S21BasicMatrix res(rows_, cols_);
+  for (int i = 0; i < rows_; ++i)
+    for (int j = 0; j < cols_; ++j)
+      res.RowPtr(i)[j] = ((i + j) % 2 ? T(-1) : T(1)) *
+                         this->HandleMatrix(i, j).Determinant();
   return res;
 }
 
-double S21Matrix::Determinant() {
-  // This function reterns a determinant of this matrix
+template <typename T>
+T S21BasicMatrix<T>::Determinant() {
+  // This function reterns a determinant of this matrix. Matrices up to 2x2
+  // use the explicit formula, bigger ones are factorized
   if (rows_ != cols_) throw CustomException("The matrix is not square");
-  S21Matrix complement = this->CalcComplements();
-  double res = 0;
-  for (int i = 0; i < rows_; ++i) res += p_[0][i] * complement.p_[0][i];
-  return res;
+  // A cached factorization costs nothing
+  [[maybe_unused]] bool work = rows_ > 2 && !(cache_ && cache_->lu);
+  S21_INSTRUMENT(S21Op::kDeterminant, work ? Size() * sizeof(T) : 0,
+                 work ? 2.0 / 3.0 * rows_ * rows_ * rows_ : 0);
+  if (rows_ == 1) return p_[0];
+  if (rows_ == 2) return p_[0] * p_[3] - p_[1] * p_[2];
+  std::optional<S21BasicLU<T>> local;
+  return Factorize(local).Determinant();
 }
 
-S21Matrix S21Matrix::InverseMatrix() {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::InverseMatrix() {
   // This function reterns an inverse matrix of this matrix
-  double det = this->Determinant();
-  if (fabs(det) < 1e-7) throw CustomException("Matrix determinant is 0");
-  S21Matrix complement = this->CalcComplements();
-  S21Matrix trasposed = complement.Transpose();
-  trasposed.MulNumber(1 / det);
-  return trasposed;
+  if (rows_ != cols_) throw CustomException("The matrix is not square");
+  // The LU copy, the identity right-hand side and the result; a cached
+  // inverse only costs the copy handed out
+  bool work = !(cache_ && cache_->inverse);
+  S21_INSTRUMENT(S21Op::kInverseMatrix,
+                 (work ? 3 : 1) * Size() * sizeof(T),
+                 work ? 2.0 * rows_ * rows_ * rows_ : 0);
+  if (!work) return *cache_->inverse;
+  std::optional<S21BasicLU<T>> local;
+  const S21BasicLU<T>& lu = Factorize(local);
+  if (std::abs(lu.Determinant()) < 1e-7)
+    throw CustomException("Matrix determinant is 0");
+  if (!cache_) return lu.Inverse();
+  // Cached results live as long as the matrix, so they come from its own
+  // resource rather than from a scope that may end first
+  {
+    S21ScopedResource scope(resource_);
+    cache_->inverse = std::make_unique<S21BasicMatrix>(lu.Inverse());
+  }
+  return *cache_->inverse;
+}
+
+template <typename T>
+void S21BasicMatrix<T>::set_caching(bool enable) {
+  if (!enable)
+    cache_.reset();
+  else if (!cache_)
+    cache_ = std::make_unique<Cache>();
 }
 
-double& S21Matrix::operator()(int row, int col) {
-  // This operator is a mutator of matrix values
-  if (row >= rows_ || col >= cols_ || col < 0 || row < 0)
-    throw std::out_of_range("Incorrect input, index is out of range");
-  return p_[row][col];
+template <typename T>
+const S21BasicLU<T>& S21BasicMatrix<T>::Factorize(
+    std::optional<S21BasicLU<T>>& local) {
+  // The cached factorization, made first if needed, or without caching a
+  // fresh one in the caller's local
+  if (!cache_) return local.emplace(*this);
+  if (!cache_->lu) {
+    S21ScopedResource scope(resource_);
+    cache_->lu = std::make_unique<S21BasicLU<T>>(*this);
+  }
+  return *cache_->lu;
 }
 
-double& S21Matrix::operator()(int row, int col) const {
-  // This operator is an accessor of matrix values
-  if (row >= rows_ || col >= cols_ || col < 0 || row < 0)
-    throw std::out_of_range("Incorrect input, index is out of range");
-  return p_[row][col];
+template <typename T>
+S21Future<S21BasicMatrix<T>> S21BasicMatrix<T>::MulMatrixAsync(
+    const S21BasicMatrix& other) const {
+  if (cols_ != other.rows_)
+    throw CustomException(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  return S21Async([a = Detach(*this), b = Detach(other)] {
+    return Multiply(a, b);
+  });
 }
 
-bool S21Matrix::operator==(const S21Matrix& other) {
+template <typename T>
+S21Future<S21BasicMatrix<T>> S21BasicMatrix<T>::InverseMatrixAsync() const {
+  if (rows_ != cols_) throw CustomException("The matrix is not square");
+  return S21Async([a = Detach(*this)]() mutable { return a.InverseMatrix(); });
+}
+
+template <typename T>
+S21Future<T> S21BasicMatrix<T>::DeterminantAsync() const {
+  if (rows_ != cols_) throw CustomException("The matrix is not square");
+  return S21Async([a = Detach(*this)]() mutable { return a.Determinant(); });
+}
+
+template <typename T>
+bool S21BasicMatrix<T>::operator==(const S21BasicMatrix& other) {
   return this->EqMatrix(other);
 }
 
-S21Matrix& S21Matrix::operator=(const S21Matrix& other) {
-  // This operator assign other matrix to this
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(const S21BasicMatrix& other) {
+  // This operator assign other matrix to this. The current block is reused
+  // whenever it holds the same number of elements, whatever the shape
   if (this == &other) return *this;  // Protection against self assignment
-  this->set_cols(other.cols_);
-  this->set_rows(other.rows_);
-  for (int i = 0; i < rows_; ++i)
-    for (int j = 0; j < cols_; ++j) p_[i][j] = other.p_[i][j];
+  S21_INSTRUMENT(S21Op::kCopy,
+                 Size() != other.Size() ? other.Size() * sizeof(T) : 0, 0);
+  InvalidateCache();
+  if (Size() != other.Size()) {
+    T* p = Allocate(other.rows_, other.cols_, false);
+    Deallocate(p_, Size());
+    p_ = p;
+  }
+  rows_ = other.rows_;
+  cols_ = other.cols_;
+  std::copy_n(other.p_, Size(), p_);
   return *this;
 }
 
-S21Matrix& S21Matrix::operator+=(const S21Matrix& other) {
-  this->SumMatrix(other);
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(S21BasicMatrix&& other) {
+  // This operator takes the block of other instead of copying it, the old
+  // block of this matrix is released right away. A block owned by another
+  // resource is copied instead, so this matrix never ends up on a resource
+  // that may go away before it (like the arena of a scope)
+  if (this == &other) return *this;
+  if (!(*resource_ == *other.resource_)) {
+    // The cached results of other live on its resource too, so only the
+    // caching setting is carried over
+    *this = other;
+    set_caching(other.get_caching());
+    InvalidateCache();
+    other.cache_.reset();
+    return *this;
+  }
+  Deallocate(p_, Size());
+  rows_ = other.rows_;
+  cols_ = other.cols_;
+  p_ = other.p_;
+  resource_ = other.resource_;
+  cache_ = std::move(other.cache_);
+  other.rows_ = 0;
+  other.cols_ = 0;
+  other.p_ = nullptr;
   return *this;
 }
 
-S21Matrix S21Matrix::operator+(const S21Matrix& other) {
-  S21Matrix res(*this);
-  res.SumMatrix(other);
-  return res;
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator+=(const S21BasicMatrix& other) {
+  this->SumMatrix(other);
+  return *this;
 }
 
-S21Matrix& S21Matrix::operator-=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator-=(const S21BasicMatrix& other) {
   this->SubMatrix(other);
   return *this;
 }
 
-S21Matrix S21Matrix::operator-(const S21Matrix& other) {
-  S21Matrix res(*this);
-  res.SubMatrix(other);
-  return res;
-}
-
-S21Matrix& S21Matrix::operator*=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator*=(const S21BasicMatrix& other) {
   this->MulMatrix(other);
   return *this;
 }
 
-S21Matrix S21Matrix::operator*(const S21Matrix& other) {
-  S21Matrix res(*this);
-  res.MulMatrix(other);
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator*(
+    const S21BasicMatrix& other) const {
+  return Multiply(*this, other);
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Multiply(
+    const S21BasicMatrixView<const T>& a, const S21BasicMatrixView<const T>& b,
+    S21MulAlgorithm algorithm) {
+  // Matrix product computed by the blocked GEMM kernel (or Strassen on top
+  // of it) straight into the result. The kernels pack their operands
+  // through their strides, so views are multiplied without copying them
+  // first
+  if (a.get_cols() != b.get_rows())
+    throw CustomException(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  S21_INSTRUMENT(S21Op::kMulMatrix,
+                 static_cast<std::size_t>(a.get_rows()) * b.get_cols() *
+                     sizeof(T),
+                 2.0 * a.get_rows() * b.get_cols() * a.get_cols());
+  int m = a.get_rows(), n = b.get_cols(), k = a.get_cols();
+  S21BasicMatrix res(m, n);
+  if (algorithm == S21MulAlgorithm::kStrassen ||
+      (algorithm == S21MulAlgorithm::kAuto &&
+       std::min({m, n, k}) >= 2 * S21GetStrassenCrossover()))
+    S21Strassen(m, n, k, a.data(), a.get_row_stride(), a.get_col_stride(),
+                b.data(), b.get_row_stride(), b.get_col_stride(), res.p_,
+                res.cols_);
+  else
+    S21Gemm(m, n, k, a.data(), a.get_row_stride(), a.get_col_stride(),
+            b.data(), b.get_row_stride(), b.get_col_stride(), res.p_,
+            res.cols_, false);
   return res;
 }
 
-S21Matrix& S21Matrix::operator*=(const double num) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator*=(const T num) {
   this->MulNumber(num);
   return *this;
 }
 
-S21Matrix operator*(double num, const S21Matrix& this_m) {
-  S21Matrix res(this_m);
-  res.MulNumber(num);
-  return res;
-}
-
-S21Matrix operator*(const S21Matrix& this_m, double num) {
-  S21Matrix res(this_m);
-  res.MulNumber(num);
-  return res;
-}
+template class S21BasicMatrix<float>;
+template class S21BasicMatrix<double>;
+template class S21BasicMatrix<long double>;
+template class S21BasicMatrix<std::complex<double>>;
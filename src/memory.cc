@@ -0,0 +1,101 @@
+#include "s21_memory.h"
+
+#include <new>
+
+namespace {
+
+// Resource set by the innermost S21ScopedResource of this thread
+thread_local std::pmr::memory_resource* current_resource = nullptr;
+
+}  // namespace
+
+std::pmr::memory_resource* S21GetResource() {
+  return current_resource ? current_resource
+                          : std::pmr::get_default_resource();
+}
+
+S21ScopedResource::S21ScopedResource(std::pmr::memory_resource* resource)
+    : previous_(current_resource) {
+  current_resource = resource;
+}
+
+S21ScopedResource::~S21ScopedResource() { current_resource = previous_; }
+
+S21PoolResource::S21PoolResource(std::size_t max_block,
+                                 std::pmr::memory_resource* upstream)
+    : max_block_(max_block), upstream_(upstream) {}
+
+S21PoolResource::~S21PoolResource() { Trim(); }
+
+int S21PoolResource::ClassOf(std::size_t bytes) {
+  // Class 0 is kMinBlock, then every range (2^e, 2^(e+1)] is split into four
+  // classes of equal width
+  if (bytes <= kMinBlock) return 0;
+  int e = 63 - __builtin_clzll(bytes - 1);
+  std::size_t step = std::size_t(1) << (e - 2);
+  std::size_t rest = bytes - (std::size_t(1) << e);
+  int sub = static_cast<int>((rest + step - 1) / step);
+  return (e - 6) * 4 + sub;
+}
+
+std::size_t S21PoolResource::ClassSize(int index) {
+  if (index == 0) return kMinBlock;
+  int e = (index - 1) / 4 + 6, sub = (index - 1) % 4 + 1;
+  return (std::size_t(1) << e) + sub * (std::size_t(1) << (e - 2));
+}
+
+void* S21PoolResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+  if (bytes > max_block_ || alignment > kAlignment)
+    return upstream_->allocate(bytes, alignment);
+  int index = ClassOf(bytes);
+  SizeClass& size_class = classes_[index];
+  {
+    std::lock_guard<std::mutex> lock(size_class.mutex);
+    if (FreeBlock* block = size_class.head) {
+      size_class.head = block->next;
+      --size_class.count;
+      return block;
+    }
+  }
+  return upstream_->allocate(ClassSize(index), kAlignment);
+}
+
+void S21PoolResource::do_deallocate(void* p, std::size_t bytes,
+                                    std::size_t alignment) {
+  if (bytes > max_block_ || alignment > kAlignment) {
+    upstream_->deallocate(p, bytes, alignment);
+    return;
+  }
+  SizeClass& size_class = classes_[ClassOf(bytes)];
+  std::lock_guard<std::mutex> lock(size_class.mutex);
+  size_class.head = new (p) FreeBlock{size_class.head};
+  ++size_class.count;
+}
+
+bool S21PoolResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+void S21PoolResource::Trim() {
+  for (int i = 0; i < kClasses; ++i) {
+    std::lock_guard<std::mutex> lock(classes_[i].mutex);
+    while (FreeBlock* block = classes_[i].head) {
+      classes_[i].head = block->next;
+      upstream_->deallocate(block, ClassSize(i), kAlignment);
+    }
+    classes_[i].count = 0;
+  }
+}
+
+std::size_t S21PoolResource::get_cached_bytes() const {
+  std::size_t bytes = 0;
+  for (int i = 0; i < kClasses; ++i) {
+    std::lock_guard<std::mutex> lock(classes_[i].mutex);
+    bytes += classes_[i].count * ClassSize(i);
+  }
+  return bytes;
+}
+
+S21ArenaScope::S21ArenaScope(std::size_t initial_size)
+    : arena_(initial_size, S21GetResource()), scope_(&arena_) {}
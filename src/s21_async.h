@@ -0,0 +1,177 @@
+#ifndef SRC_S21_ASYNC_H_
+#define SRC_S21_ASYNC_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_exception.h"
+#include "s21_thread_pool.h"
+
+// Asynchronous operations on the shared S21ThreadPool. S21Async() queues a
+// function and returns an S21Future of its result; given futures, the
+// function only starts once all of them are ready and receives their
+// values, so a DAG of operations is built without any thread blocking on
+// an unfinished one. Independent branches run concurrently, and each
+// operation still splits its own loops over the pool
+//
+// A task must not wait (Get(), Wait()) on a future that is not ready: the
+// workers it would block are the ones that have to produce it. Chain the
+// dependent work with Then() or S21Async() instead
+
+template <typename R>
+class S21Future;
+
+// Type a task result is stored as. Results that refer to data they do not
+// own, like the lazy matrix expressions, are specialized to a type holding
+// a copy (see s21_matrix_oop.h)
+template <typename R, typename = void>
+struct S21AsyncValue {
+  using type = R;
+};
+
+template <typename F, typename... Args>
+using S21AsyncResult = typename S21AsyncValue<
+    std::decay_t<std::invoke_result_t<F&, const Args&...>>>::type;
+
+template <typename F, typename... Args>
+auto S21Async(F f, S21Future<Args>... deps)
+    -> S21Future<S21AsyncResult<F, Args...>>;
+
+template <typename R>
+class S21Future {
+  // Shared handle to a result computed on the pool, copies refer to the
+  // same result. An exception thrown by the computation (or by one of its
+  // dependencies) is stored and rethrown by Get()
+  static_assert(!std::is_void<R>::value, "Asynchronous tasks return a value");
+
+ private:
+  struct State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool ready = false;
+    std::optional<R> value;
+    std::exception_ptr error;
+    // Run once, right after the result is set
+    std::vector<std::function<void()>> continuations;
+  };
+
+  std::shared_ptr<State> state_;
+
+  template <typename F, typename... Args>
+  friend auto S21Async(F f, S21Future<Args>... deps)
+      -> S21Future<S21AsyncResult<F, Args...>>;
+  template <typename>
+  friend class S21Future;
+
+  static S21Future Create() {
+    S21Future res;
+    res.state_ = std::make_shared<State>();
+    return res;
+  }
+
+  void Complete(std::optional<R> value, std::exception_ptr error) const {
+    std::vector<std::function<void()>> continuations;
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      state_->value = std::move(value);
+      state_->error = error;
+      state_->ready = true;
+      continuations.swap(state_->continuations);
+    }
+    state_->cv.notify_all();
+    for (auto& continuation : continuations) continuation();
+  }
+
+  void CheckValid() const {
+    if (!state_) throw CustomException("The future has no result");
+  }
+
+  // Calls the function when the result is set, right away if it already is
+  void OnReady(std::function<void()> function) const {
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      if (!state_->ready) {
+        state_->continuations.push_back(std::move(function));
+        return;
+      }
+    }
+    function();
+  }
+
+ public:
+  // An empty future, which has no result to wait for
+  S21Future() = default;
+  // A future that is ready with the given value
+  explicit S21Future(R value) : state_(std::make_shared<State>()) {
+    state_->value = std::move(value);
+    state_->ready = true;
+  }
+
+  bool IsValid() const { return state_ != nullptr; }
+  // These throw for an empty future
+  bool IsReady() const {
+    CheckValid();
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->ready;
+  }
+  void Wait() const {
+    CheckValid();
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->cv.wait(lock, [this] { return state_->ready; });
+  }
+  // Waits for the result; it stays owned by the future
+  const R& Get() const {
+    Wait();
+    if (state_->error) std::rethrow_exception(state_->error);
+    return *state_->value;
+  }
+
+  // Queues f(result) to run once this future is ready
+  template <typename F>
+  auto Then(F f) const {
+    CheckValid();
+    return S21Async(std::move(f), *this);
+  }
+};
+
+template <typename F, typename... Args>
+auto S21Async(F f, S21Future<Args>... deps)
+    -> S21Future<S21AsyncResult<F, Args...>> {
+  // Every dependency and the call itself hold one count; whoever drops the
+  // last one submits the task. A failed dependency fails the result without
+  // calling f
+  using R = S21AsyncResult<F, Args...>;
+  (deps.CheckValid(), ...);
+  S21Future<R> res = S21Future<R>::Create();
+  auto job = std::make_shared<std::function<void()>>(
+      [res, f = std::move(f), deps...]() mutable {
+        std::exception_ptr error;
+        ((error = error ? error : deps.state_->error), ...);
+        if (error) return res.Complete(std::nullopt, error);
+        std::optional<R> value;
+        try {
+          value.emplace(f(*deps.state_->value...));
+        } catch (...) {
+          return res.Complete(std::nullopt, std::current_exception());
+        }
+        res.Complete(std::move(value), nullptr);
+      });
+  auto remaining = std::make_shared<std::atomic<int>>(sizeof...(Args) + 1);
+  auto arrive = [remaining, job] {
+    if (remaining->fetch_sub(1) == 1)
+      S21ThreadPool::Instance().Submit([job] { (*job)(); });
+  };
+  (deps.OnReady(arrive), ...);
+  arrive();
+  return res;
+}
+
+#endif  // SRC_S21_ASYNC_H_
@@ -0,0 +1,18 @@
+#ifndef SRC_S21_EXCEPTION_H_
+#define SRC_S21_EXCEPTION_H_
+
+#include <exception>
+
+class CustomException : public std::exception {
+  // Custom exception class
+ private:
+  char const* message_;
+
+ public:
+  // Constructor simply copies the message given to it to a fieild of a class
+  explicit CustomException(char const* msg) { message_ = msg; }
+  // What is default exception function that returns an explanatory string
+  char const* what() { return message_; }
+};
+
+#endif  // SRC_S21_EXCEPTION_H_
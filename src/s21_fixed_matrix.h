@@ -0,0 +1,288 @@
+#ifndef SRC_S21_FIXED_MATRIX_H_
+#define SRC_S21_FIXED_MATRIX_H_
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_matrix_oop.h"
+
+template <int R, int C, typename T = double>
+class S21FixedMatrix {
+  // Matrix with dimensions known at compile time. Values live inside the
+  // object (no heap), every operation is constexpr and the loops have
+  // constant bounds (products are spelled out through index sequences), so
+  // 2x2 .. 4x4 math compiles down to straight-line code. For a complex T
+  // the operations that take magnitudes (EqMatrix(), InverseMatrix() and
+  // Determinant() above 4x4) only run at run time, as std::abs does
+  static_assert(R > 0 && C > 0, "Rows and cols must be not less that 1");
+
+ public:
+  using value_type = T;
+
+ private:
+  T p_[R * C];
+
+  // Magnitude of a scalar; constexpr for real T, a complex one goes
+  // through std::abs
+  using Real = decltype(std::abs(std::declval<T>()));
+  static constexpr Real Abs(T value) {
+    if constexpr (std::is_arithmetic<T>::value)
+      return value < T(0) ? -value : value;
+    else
+      return std::abs(value);
+  }
+
+  template <int K, int N, std::size_t... Ks>
+  static constexpr T Dot(const S21FixedMatrix<R, K, T>& a,
+                         const S21FixedMatrix<K, N, T>& b, int i, int j,
+                         std::index_sequence<Ks...>) {
+    return ((a.p_[i * K + Ks] * b.p_[Ks * N + j]) + ...);
+  }
+
+  // Matrix without row ex_i and column ex_j
+  constexpr S21FixedMatrix<R - 1, C - 1, T> Minor(int ex_i, int ex_j) const {
+    S21FixedMatrix<R - 1, C - 1, T> res;
+    for (int i = 0, i_b = 0; i < R; ++i) {
+      if (i == ex_i) continue;
+      for (int j = 0, j_b = 0; j < C; ++j) {
+        if (j == ex_j) continue;
+        res.p_[i_b * (C - 1) + j_b] = p_[i * C + j];
+        ++j_b;
+      }
+      ++i_b;
+    }
+    return res;
+  }
+
+  constexpr T EliminationDeterminant() const {
+    // Gaussian elimination with partial pivoting for sizes where cofactor
+    // expansion would blow up
+    S21FixedMatrix a(*this);
+    T res(1);
+    for (int k = 0; k < R; ++k) {
+      int pivot = k;
+      for (int i = k + 1; i < R; ++i)
+        if (Abs(a.p_[i * C + k]) > Abs(a.p_[pivot * C + k])) pivot = i;
+      if (a.p_[pivot * C + k] == T(0)) return T(0);
+      if (pivot != k) {
+        for (int j = 0; j < C; ++j) {
+          T tmp = a.p_[k * C + j];
+          a.p_[k * C + j] = a.p_[pivot * C + j];
+          a.p_[pivot * C + j] = tmp;
+        }
+        res = -res;
+      }
+      res *= a.p_[k * C + k];
+      for (int i = k + 1; i < R; ++i) {
+        T l = a.p_[i * C + k] / a.p_[k * C + k];
+        for (int j = k; j < C; ++j) a.p_[i * C + j] -= l * a.p_[k * C + j];
+      }
+    }
+    return res;
+  }
+
+  template <int, int, typename>
+  friend class S21FixedMatrix;
+
+ public:
+  // Zero-matrix
+  constexpr S21FixedMatrix() : p_() {}
+  // Values listed row by row, missing ones are zeroes
+  constexpr S21FixedMatrix(std::initializer_list<T> values) : p_() {
+    if (values.size() > static_cast<std::size_t>(R * C))
+      throw CustomException("Too many values for the matrix");
+    int i = 0;
+    for (const T& value : values) p_[i++] = value;
+  }
+  // Conversion from a dynamic matrix of the same size and scalar type
+  explicit S21FixedMatrix(const S21BasicMatrix<T>& other) : p_() {
+    if (other.get_rows() != R || other.get_cols() != C)
+      throw CustomException("Different matrix dimensions");
+    for (int i = 0; i < R; ++i)
+      for (int j = 0; j < C; ++j) p_[i * C + j] = other(i, j);
+  }
+  // Conversion to a dynamic matrix
+  operator S21BasicMatrix<T>() const {
+    S21BasicMatrix<T> res(R, C);
+    for (int i = 0; i < R; ++i)
+      for (int j = 0; j < C; ++j) res(i, j) = p_[i * C + j];
+    return res;
+  }
+
+  static constexpr int get_rows() { return R; }
+  static constexpr int get_cols() { return C; }
+
+  // Element access. The bounds check folds away for constant indices, At()
+  // checks them at compile time
+  constexpr T& operator()(int row, int col) {
+    if (row >= R || col >= C || col < 0 || row < 0)
+      throw std::out_of_range("Incorrect input, index is out of range");
+    return p_[row * C + col];
+  }
+  constexpr const T& operator()(int row, int col) const {
+    if (row >= R || col >= C || col < 0 || row < 0)
+      throw std::out_of_range("Incorrect input, index is out of range");
+    return p_[row * C + col];
+  }
+  template <int I, int J>
+  constexpr T& At() {
+    static_assert(I >= 0 && I < R && J >= 0 && J < C, "Index is out of range");
+    return p_[I * C + J];
+  }
+  template <int I, int J>
+  constexpr const T& At() const {
+    static_assert(I >= 0 && I < R && J >= 0 && J < C, "Index is out of range");
+    return p_[I * C + J];
+  }
+
+  constexpr bool EqMatrix(const S21FixedMatrix& other) const {
+    for (int i = 0; i < R * C; ++i)
+      if (Abs(p_[i] - other.p_[i]) > Real(1e-7)) return false;
+    return true;
+  }
+  constexpr void SumMatrix(const S21FixedMatrix& other) {
+    for (int i = 0; i < R * C; ++i) p_[i] += other.p_[i];
+  }
+  constexpr void SubMatrix(const S21FixedMatrix& other) {
+    for (int i = 0; i < R * C; ++i) p_[i] -= other.p_[i];
+  }
+  constexpr void MulNumber(const T num) {
+    for (int i = 0; i < R * C; ++i) p_[i] *= num;
+  }
+  template <int N>
+  constexpr S21FixedMatrix<R, N, T> MulMatrix(
+      const S21FixedMatrix<C, N, T>& other) const {
+    S21FixedMatrix<R, N, T> res;
+    for (int i = 0; i < R; ++i)
+      for (int j = 0; j < N; ++j)
+        res.p_[i * N + j] =
+            Dot<C, N>(*this, other, i, j, std::make_index_sequence<C>());
+    return res;
+  }
+  constexpr S21FixedMatrix<C, R, T> Transpose() const {
+    S21FixedMatrix<C, R, T> res;
+    for (int i = 0; i < R; ++i)
+      for (int j = 0; j < C; ++j) res.p_[j * R + i] = p_[i * C + j];
+    return res;
+  }
+  constexpr T Determinant() const {
+    // Explicit cofactor expansion up to 4x4, elimination above
+    static_assert(R == C, "The matrix is not square");
+    if constexpr (R == 1) {
+      return p_[0];
+    } else if constexpr (R == 2) {
+      return p_[0] * p_[3] - p_[1] * p_[2];
+    } else if constexpr (R <= 4) {
+      T res(0);
+      for (int j = 0; j < C; ++j)
+        res += (j % 2 ? -p_[j] : p_[j]) * Minor(0, j).Determinant();
+      return res;
+    } else {
+      return EliminationDeterminant();
+    }
+  }
+  constexpr S21FixedMatrix CalcComplements() const {
+    static_assert(R == C, "The matrix is not square");
+    if constexpr (R == 1) {
+      return *this;
+    } else {
+      S21FixedMatrix res;
+      for (int i = 0; i < R; ++i)
+        for (int j = 0; j < C; ++j) {
+          T minor = Minor(i, j).Determinant();
+          res.p_[i * C + j] = (i + j) % 2 ? -minor : minor;
+        }
+      return res;
+    }
+  }
+  constexpr S21FixedMatrix InverseMatrix() const {
+    // A^-1 = adj(A) / det(A), the adjugate being the transposed complements
+    static_assert(R == C, "The matrix is not square");
+    T det = Determinant();
+    if (Abs(det) < Real(1e-7)) throw CustomException("Matrix determinant is 0");
+    if constexpr (R == 1) {
+      return S21FixedMatrix{T(1) / det};
+    } else {
+      S21FixedMatrix res = CalcComplements().Transpose();
+      res.MulNumber(T(1) / det);
+      return res;
+    }
+  }
+
+  constexpr bool operator==(const S21FixedMatrix& other) const {
+    return EqMatrix(other);
+  }
+  constexpr S21FixedMatrix& operator+=(const S21FixedMatrix& other) {
+    SumMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator-=(const S21FixedMatrix& other) {
+    SubMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(const T num) {
+    MulNumber(num);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(const S21FixedMatrix<C, C, T>& other) {
+    *this = MulMatrix(other);
+    return *this;
+  }
+  friend constexpr S21FixedMatrix operator+(S21FixedMatrix lhs,
+                                            const S21FixedMatrix& rhs) {
+    return lhs += rhs;
+  }
+  friend constexpr S21FixedMatrix operator-(S21FixedMatrix lhs,
+                                            const S21FixedMatrix& rhs) {
+    return lhs -= rhs;
+  }
+  friend constexpr S21FixedMatrix operator*(S21FixedMatrix lhs, const T num) {
+    return lhs *= num;
+  }
+  friend constexpr S21FixedMatrix operator*(const T num, S21FixedMatrix rhs) {
+    return rhs *= num;
+  }
+  template <int N>
+  friend constexpr S21FixedMatrix<R, N, T> operator*(
+      const S21FixedMatrix& lhs, const S21FixedMatrix<C, N, T>& rhs) {
+    return lhs.MulMatrix(rhs);
+  }
+
+  // Mixed operations with dynamic matrices give dynamic matrices
+  friend S21BasicMatrix<T> operator+(const S21FixedMatrix& lhs,
+                                     const S21BasicMatrix<T>& rhs) {
+    return S21BasicMatrix<T>(lhs) + rhs;
+  }
+  friend S21BasicMatrix<T> operator+(const S21BasicMatrix<T>& lhs,
+                                     const S21FixedMatrix& rhs) {
+    return lhs + S21BasicMatrix<T>(rhs);
+  }
+  friend S21BasicMatrix<T> operator-(const S21FixedMatrix& lhs,
+                                     const S21BasicMatrix<T>& rhs) {
+    return S21BasicMatrix<T>(lhs) - rhs;
+  }
+  friend S21BasicMatrix<T> operator-(const S21BasicMatrix<T>& lhs,
+                                     const S21FixedMatrix& rhs) {
+    return lhs - S21BasicMatrix<T>(rhs);
+  }
+  friend S21BasicMatrix<T> operator*(const S21FixedMatrix& lhs,
+                                     const S21BasicMatrix<T>& rhs) {
+    return S21BasicMatrix<T>(lhs) * rhs;
+  }
+  friend S21BasicMatrix<T> operator*(const S21BasicMatrix<T>& lhs,
+                                     const S21FixedMatrix& rhs) {
+    return lhs * S21BasicMatrix<T>(rhs);
+  }
+};
+
+// Common small shapes
+using S21Matrix2 = S21FixedMatrix<2, 2>;
+using S21Matrix3 = S21FixedMatrix<3, 3>;
+using S21Matrix4 = S21FixedMatrix<4, 4>;
+
+#endif  // SRC_S21_FIXED_MATRIX_H_
@@ -0,0 +1,104 @@
+#ifndef SRC_S21_INSTRUMENT_H_
+#define SRC_S21_INSTRUMENT_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Opt-in performance counters of the hot S21Matrix operations. The hooks are
+// compiled into the library only when S21_MATRIX_INSTRUMENT is defined
+// (make rebuild INSTRUMENT=1); otherwise they expand to nothing and every
+// snapshot reports zeroes
+
+enum class S21Op {
+  kConstruct,
+  kCopy,
+  kMulMatrix,
+  kInverseMatrix,
+  kDeterminant,
+  kCount
+};
+
+// Totals of one operation since the last Reset()
+struct S21OpStats {
+  const char* name;
+  std::uint64_t calls;
+  std::uint64_t total_ns;
+  // Latency percentiles, read from a log-scale histogram whose buckets are
+  // at most 25% wide; the upper bound of the bucket is reported
+  std::uint64_t p50_ns, p90_ns, p99_ns;
+  std::uint64_t bytes;  // allocated for the result and temporaries
+  std::uint64_t flops;
+  std::uint64_t cache_misses;  // only counted with perf events enabled
+};
+
+class S21Instrument {
+  // Process-wide registry of the counters. Recording is lock-free (relaxed
+  // atomics), so instrumented operations can run on any thread
+ public:
+  static S21Instrument& Instance();
+  // True when the library was built with S21_MATRIX_INSTRUMENT
+  static bool IsCompiledIn();
+
+  S21Instrument(const S21Instrument&) = delete;
+  S21Instrument& operator=(const S21Instrument&) = delete;
+
+  void Record(S21Op op, std::uint64_t ns, std::uint64_t bytes,
+              std::uint64_t flops, std::uint64_t cache_misses);
+  void Reset();
+  // One entry per operation, in the order of S21Op
+  std::vector<S21OpStats> Snapshot() const;
+  std::string ToJson() const;
+  // Prometheus text exposition format
+  std::string ToPrometheus() const;
+
+  // Counts cache misses of the thread running each operation through Linux
+  // perf_event_open. Returns false (and stays off) when the kernel refuses
+  bool EnablePerfEvents(bool enable);
+  bool get_perf_events() const { return perf_events_; }
+  // Running cache-miss count of the calling thread, 0 when perf events are
+  // off or unavailable on this thread
+  std::uint64_t ReadCacheMisses() const;
+
+ private:
+  static constexpr int kBuckets = 256;
+  struct Counters {
+    std::atomic<std::uint64_t> calls, total_ns, bytes, flops, cache_misses;
+    std::array<std::atomic<std::uint64_t>, kBuckets> histogram;
+  };
+
+  S21Instrument();
+  static int Bucket(std::uint64_t ns);
+  static std::uint64_t BucketLimit(int bucket);
+  std::uint64_t Percentile(const Counters& counters, std::uint64_t calls,
+                           double q) const;
+
+  std::array<Counters, static_cast<int>(S21Op::kCount)> counters_;
+  std::atomic<bool> perf_events_;
+};
+
+// Measures the scope it lives in and records it when destroyed
+class S21OpTimer {
+ public:
+  S21OpTimer(S21Op op, std::uint64_t bytes, double flops);
+  S21OpTimer(const S21OpTimer&) = delete;
+  S21OpTimer& operator=(const S21OpTimer&) = delete;
+  ~S21OpTimer();
+
+ private:
+  S21Op op_;
+  std::uint64_t bytes_, flops_, cache_misses_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+#ifdef S21_MATRIX_INSTRUMENT
+#define S21_INSTRUMENT(op, bytes, flops) \
+  S21OpTimer s21_op_timer_((op), (bytes), (flops))
+#else
+#define S21_INSTRUMENT(op, bytes, flops) static_cast<void>(0)
+#endif
+
+#endif  // SRC_S21_INSTRUMENT_H_
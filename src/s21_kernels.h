@@ -0,0 +1,78 @@
+#ifndef SRC_S21_KERNELS_H_
+#define SRC_S21_KERNELS_H_
+
+#include <cstddef>
+
+// Internal computational kernels used by S21Matrix. They work on raw memory
+// described by a pointer and strides, so the same kernel serves whole
+// matrices as well as transposed or partial operands
+
+// Register tile of the GEMM micro-kernel (rows x columns of C)
+constexpr int kS21GemmMr = 4;
+constexpr int kS21GemmNr = 8;
+
+// Instruction sets with dedicated kernels, ordered from the weakest one
+enum class S21SimdLevel { kScalar, kSse2, kAvx2, kAvx512 };
+
+// Table of kernels over the scalar type T for one instruction set. All of
+// them accept unaligned pointers and any length. float and double have
+// vectorized versions, other types always get the portable ones
+template <typename T>
+struct S21SimdKernels {
+  void (*add)(T* dst, const T* src, std::size_t n);
+  void (*sub)(T* dst, const T* src, std::size_t n);
+  void (*scale)(T* dst, T num, std::size_t n);
+  // True when |a[i] - b[i]| <= eps for every i, stops at the first
+  // mismatching block
+  bool (*equal)(const T* a, const T* b, std::size_t n, double eps);
+  // Multiplies packed kS21GemmMr x kc and kc x kS21GemmNr slivers into the
+  // top-left mr x nr corner of C
+  void (*micro_kernel)(int kc, const T* a, const T* b, T* c,
+                       std::ptrdiff_t ldc, int mr, int nr, bool accumulate);
+};
+
+// Best level supported by the running CPU (capped by S21_MATRIX_SIMD)
+S21SimdLevel S21DetectSimdLevel();
+S21SimdLevel S21GetSimdLevel();
+// Switches every kernel to the given level (clamped to the detected one) and
+// returns the level actually used
+S21SimdLevel S21SetSimdLevel(S21SimdLevel level);
+// Kernels of the active level, chosen at runtime via CPUID
+template <typename T>
+const S21SimdKernels<T>& S21Kernels();
+
+// C = A * B (or C += A * B when accumulate is true), where A is m x k, B is
+// k x n and C is m x n. Element (i, j) of A is a[i * rsa + j * csa], the same
+// for B; C is row-major with leading dimension ldc
+template <typename T>
+void S21Gemm(int m, int n, int k, const T* a, std::ptrdiff_t rsa,
+             std::ptrdiff_t csa, const T* b, std::ptrdiff_t rsb,
+             std::ptrdiff_t csb, T* c, std::ptrdiff_t ldc, bool accumulate);
+
+// Strassen-Winograd product C = A * B (same operand layout as S21Gemm, C
+// is overwritten). Recurses while every dimension is above the crossover
+// and calls S21Gemm below it
+template <typename T>
+void S21Strassen(int m, int n, int k, const T* a, std::ptrdiff_t rsa,
+                 std::ptrdiff_t csa, const T* b, std::ptrdiff_t rsb,
+                 std::ptrdiff_t csb, T* c, std::ptrdiff_t ldc);
+// Size below which Strassen hands over to the regular kernel; a value of 0
+// or less restores the default
+int S21GetStrassenCrossover();
+void S21SetStrassenCrossover(int size);
+
+// Writes the transpose of the rows x cols matrix src (row stride lds) into dst
+// (row stride ldd) with a cache-oblivious recursive blocking
+template <typename T>
+void S21Transpose(int rows, int cols, const T* src, std::ptrdiff_t lds,
+                  T* dst, std::ptrdiff_t ldd);
+// Transposes the n x n matrix a (row stride lda) in place, tile by tile
+template <typename T>
+void S21TransposeInPlace(int n, T* a, std::ptrdiff_t lda);
+// Turns the contiguous rows x cols matrix a into its cols x rows transpose
+// by following the cycles of the permutation, with one bit of extra memory
+// per element
+template <typename T>
+void S21TransposeInPlace(int rows, int cols, T* a);
+
+#endif  // SRC_S21_KERNELS_H_
@@ -0,0 +1,74 @@
+#ifndef SRC_S21_MATRIX_BATCH_H_
+#define SRC_S21_MATRIX_BATCH_H_
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+template <typename T>
+class S21BasicMatrixBatch {
+  // A batch of count independent matrices of the same rows x cols size. The
+  // matrices are stored interleaved in groups of kLanes: inside a group
+  // element (i, j) of all kLanes matrices is contiguous. A batched operation
+  // then runs every step of the algorithm on kLanes matrices at once (the
+  // lane loops are vectorized by the compiler), and groups are spread over
+  // the thread pool, with no per-matrix object, allocation or call
+ public:
+  using value_type = T;
+  static constexpr int kLanes = 16;
+
+ private:
+  int count_, rows_, cols_;
+  T* p_;
+  std::pmr::memory_resource* resource_;
+
+  int Groups() const { return (count_ + kLanes - 1) / kLanes; }
+  std::size_t GroupSize() const {
+    return static_cast<std::size_t>(rows_) * cols_ * kLanes;
+  }
+  T* Group(int group) const { return p_ + group * GroupSize(); }
+  T* Element(int index, int row, int col) const {
+    return Group(index / kLanes) +
+           (static_cast<std::size_t>(row) * cols_ + col) * kLanes +
+           index % kLanes;
+  }
+  void Release();
+
+ public:
+  // Every matrix of a new batch is a zero matrix
+  S21BasicMatrixBatch(int count, int rows, int cols);
+  S21BasicMatrixBatch(int count, int rows, int cols,
+                      std::pmr::memory_resource* resource);
+  S21BasicMatrixBatch(const S21BasicMatrixBatch& other);
+  S21BasicMatrixBatch(S21BasicMatrixBatch&& other) noexcept;
+  S21BasicMatrixBatch& operator=(const S21BasicMatrixBatch& other);
+  S21BasicMatrixBatch& operator=(S21BasicMatrixBatch&& other);
+  ~S21BasicMatrixBatch();
+
+  int get_count() const { return count_; }
+  int get_rows() const { return rows_; }
+  int get_cols() const { return cols_; }
+
+  // Element (row, col) of the matrix number index
+  T& operator()(int index, int row, int col);
+  const T& operator()(int index, int row, int col) const;
+  // Copies one matrix out of or into the batch
+  S21BasicMatrix<T> Get(int index) const;
+  void Set(int index, const S21BasicMatrix<T>& matrix);
+
+  // Products of the matching matrices of both batches
+  S21BasicMatrixBatch Multiply(const S21BasicMatrixBatch& other) const;
+  // Determinants of every matrix, by elimination with partial pivoting
+  std::vector<T> Determinant() const;
+  // Inverses of every matrix, throws if any of them is singular
+  S21BasicMatrixBatch Inverse() const;
+  // Solves A[k] * X[k] = B[k] for every k, B[k] may have several columns
+  S21BasicMatrixBatch Solve(const S21BasicMatrixBatch& b) const;
+};
+
+using S21MatrixBatch = S21BasicMatrixBatch<double>;
+using S21MatrixBatchF = S21BasicMatrixBatch<float>;
+
+#endif  // SRC_S21_MATRIX_BATCH_H_
@@ -0,0 +1,109 @@
+#ifndef SRC_S21_MATRIX_FILE_H_
+#define SRC_S21_MATRIX_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "s21_matrix_oop.h"
+
+// Binary matrix file: a 64-byte header followed by the elements in row-major
+// order, starting at data_offset (a multiple of 64, so a mapped file keeps
+// the alignment of S21Matrix storage). All header fields are written in the
+// byte order given by endian
+struct S21MatrixFileHeader {
+  char magic[4];               // "S21M"
+  std::uint16_t version;       // kS21MatrixFileVersion
+  std::uint8_t dtype;          // S21MatrixFileType<T>::kCode
+  std::uint8_t endian;         // 1 little-endian, 2 big-endian
+  std::uint32_t element_size;  // sizeof(T)
+  std::uint32_t reserved;
+  std::int64_t rows, cols;
+  std::uint64_t data_offset;
+  std::uint8_t padding[24];
+};
+static_assert(sizeof(S21MatrixFileHeader) == 64, "Header must be 64 bytes");
+
+constexpr std::uint16_t kS21MatrixFileVersion = 1;
+
+// Element type codes: 1 float, 2 double, 3 long double, 4 complex<double>
+template <typename T>
+struct S21MatrixFileType;
+
+// Writes a matrix file row by row, so a matrix never has to be in memory as
+// a whole. Rows must be written in order; Close() checks that every row has
+// been written and throws otherwise
+template <typename T>
+class S21BasicMatrixWriter {
+ public:
+  S21BasicMatrixWriter(const std::string& path, int rows, int cols);
+  S21BasicMatrixWriter(const S21BasicMatrixWriter&) = delete;
+  S21BasicMatrixWriter& operator=(const S21BasicMatrixWriter&) = delete;
+  ~S21BasicMatrixWriter();
+
+  int get_rows_written() const { return rows_written_; }
+  // Appends count contiguous rows
+  void WriteRows(const T* data, int count);
+  // Appends every row of a matrix or a view
+  void WriteRows(const S21BasicMatrixView<const T>& rows);
+  void Close();
+
+ private:
+  int fd_;
+  int rows_, cols_, rows_written_;
+};
+
+// Read-only memory mapping of a matrix file: the elements are never copied,
+// pages are loaded by the OS on first access. View() exposes the mapping as
+// a read-only S21BasicMatrixView that works with every expression and
+// product; copy it into an S21Matrix to modify it
+template <typename T>
+class S21BasicMappedMatrix {
+ public:
+  explicit S21BasicMappedMatrix(const std::string& path);
+  S21BasicMappedMatrix(const S21BasicMappedMatrix&) = delete;
+  S21BasicMappedMatrix& operator=(const S21BasicMappedMatrix&) = delete;
+  ~S21BasicMappedMatrix();
+
+  int get_rows() const { return rows_; }
+  int get_cols() const { return cols_; }
+  const T* data() const { return data_; }
+  const T& operator()(int row, int col) const;
+  S21BasicMatrixView<const T> View() const;
+
+ private:
+  void* base_;
+  std::size_t length_;
+  T* data_;
+  int rows_, cols_;
+};
+
+// Whole-matrix helpers: Save streams the rows out, Load reads the file in
+// large chunks straight into the storage of the new matrix (converting the
+// byte order if needed)
+template <typename T>
+void S21SaveMatrix(const std::string& path, const S21BasicMatrix<T>& m);
+template <typename T>
+void S21SaveMatrix(const std::string& path,
+                   const S21BasicMatrixView<const T>& m);
+// A writable view is saved as a read-only one
+template <typename T>
+void S21SaveMatrix(const std::string& path, const S21BasicMatrixView<T>& m) {
+  S21SaveMatrix(path, S21BasicMatrixView<const T>(m));
+}
+template <typename T>
+S21BasicMatrix<T> S21LoadMatrix(const std::string& path);
+
+// Out-of-core product: writes A * B into the file c_path, where A and B are
+// matrix files that do not have to fit in memory. The operands stream
+// through square tiles sized so that at most memory_budget bytes are
+// buffered, each tile product runs on the in-memory GEMM kernel and reading
+// the next tiles overlaps with it
+template <typename T>
+void S21MultiplyFiles(const std::string& a_path, const std::string& b_path,
+                      const std::string& c_path, std::size_t memory_budget);
+
+using S21MatrixWriter = S21BasicMatrixWriter<double>;
+using S21MappedMatrix = S21BasicMappedMatrix<double>;
+
+#endif  // SRC_S21_MATRIX_FILE_H_
@@ -0,0 +1,130 @@
+#ifndef SRC_S21_MATRIX_GRAPH_H_
+#define SRC_S21_MATRIX_GRAPH_H_
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+template <typename T>
+class S21BasicMatrixGraph;
+
+template <typename T>
+class S21BasicLazyMatrix {
+  // Handle to a node of an S21BasicMatrixGraph. The operators only record
+  // the operation and check the sizes; nothing is computed until Evaluate()
+  // or Determinant() is called. Handles are cheap to copy and must not
+  // outlive their graph
+ private:
+  S21BasicMatrixGraph<T>* graph_;
+  int id_;
+
+  friend class S21BasicMatrixGraph<T>;
+
+  S21BasicLazyMatrix(S21BasicMatrixGraph<T>* graph, int id)
+      : graph_(graph), id_(id) {}
+
+ public:
+  // Equal ids mean the same (deduplicated) subexpression
+  int get_id() const { return id_; }
+  int get_rows() const;
+  int get_cols() const;
+
+  S21BasicLazyMatrix operator+(const S21BasicLazyMatrix& other) const;
+  S21BasicLazyMatrix operator-(const S21BasicLazyMatrix& other) const;
+  S21BasicLazyMatrix operator*(const S21BasicLazyMatrix& other) const;
+  S21BasicLazyMatrix operator*(const T num) const;
+  friend S21BasicLazyMatrix operator*(const T num,
+                                      const S21BasicLazyMatrix& matrix) {
+    return matrix * num;
+  }
+  S21BasicLazyMatrix Transpose() const;
+  S21BasicLazyMatrix InverseMatrix() const;
+
+  // Computes the node, and whatever it depends on, unless done before. The
+  // reference stays valid as long as the graph
+  const S21BasicMatrix<T>& Evaluate() const;
+  T Determinant() const;
+};
+
+template <typename T>
+class S21BasicMatrixGraph {
+  // Deferred evaluation of S21Matrix operations. Expressions built from the
+  // handles of Input() form a DAG that is optimized while it is recorded:
+  //  - identical subexpressions are hash-consed into one node (a + b and
+  //    b + a included), so they are computed once;
+  //  - the transpose of a transpose is the operand itself, a scale by 1 is
+  //    dropped and the determinant of a transpose is the one of its operand;
+  //  - a transpose feeding a product, a sum or a scale is never
+  //    materialized, the operation reads its operand through a transposed
+  //    view (for a product the GEMM packs it straight from there).
+  // Every computed node keeps its value, and a node that is factorized (for
+  // Determinant() or InverseMatrix()) keeps its LU, so asking for the
+  // determinant and then the inverse factorizes once. Inputs are read by
+  // reference when first needed; after changing one, call Invalidate().
+  // Shapes are fixed when recorded, so an input must keep its size
+  // (evaluation throws otherwise), and handles of different graphs do not
+  // mix. A graph is meant for one thread
+ public:
+  S21BasicMatrixGraph() = default;
+  S21BasicMatrixGraph(const S21BasicMatrixGraph&) = delete;
+  S21BasicMatrixGraph& operator=(const S21BasicMatrixGraph&) = delete;
+
+  // Leaf for a matrix that must outlive the graph; the same matrix always
+  // gives the same node
+  S21BasicLazyMatrix<T> Input(const S21BasicMatrix<T>& matrix);
+
+  int get_node_count() const { return static_cast<int>(nodes_.size()); }
+  // Matrices computed and factorizations made so far
+  int get_computed_count() const { return computed_; }
+  // Forgets every computed value and factorization
+  void Invalidate();
+
+ private:
+  enum class Kind { kInput, kAdd, kSub, kMul, kScale, kTranspose, kInverse };
+
+  struct Key {
+    Kind kind;
+    int lhs, rhs;
+    T scalar;
+    const S21BasicMatrix<T>* input;
+
+    bool operator==(const Key& other) const;
+  };
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const;
+  };
+  struct Node {
+    Key key;
+    int rows, cols;
+    std::unique_ptr<S21BasicMatrix<T>> value;
+    std::unique_ptr<S21BasicLU<T>> lu;
+  };
+
+  std::vector<Node> nodes_;
+  std::unordered_map<Key, int, KeyHash> index_;
+  int computed_ = 0;
+
+  friend class S21BasicLazyMatrix<T>;
+
+  S21BasicLazyMatrix<T> Intern(const Key& key, int rows, int cols);
+  S21BasicLazyMatrix<T> Binary(Kind kind, const S21BasicLazyMatrix<T>& x,
+                               const S21BasicLazyMatrix<T>& y);
+  S21BasicLazyMatrix<T> Scale(int id, T num);
+  S21BasicLazyMatrix<T> Transpose(int id);
+  S21BasicLazyMatrix<T> Inverse(int id);
+
+  const S21BasicMatrix<T>& Evaluate(int id);
+  // Operand of a fused operation: a transpose node is read as a transposed
+  // view of its operand instead of being computed
+  S21BasicMatrixView<const T> Operand(int id);
+  const S21BasicLU<T>& Factor(int id);
+  T Determinant(int id);
+};
+
+using S21MatrixGraph = S21BasicMatrixGraph<double>;
+using S21LazyMatrix = S21BasicLazyMatrix<double>;
+
+#endif  // SRC_S21_MATRIX_GRAPH_H_
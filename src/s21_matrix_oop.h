@@ -1,82 +1,862 @@
 #ifndef SRC_S21_MATRIX_OOP_H_
 #define SRC_S21_MATRIX_OOP_H_
 
+#include <algorithm>
 #include <cmath>
+#include <complex>
+#include <cstddef>
 #include <exception>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-class CustomException : public std::exception {
-  // Custom exception class
- private:
-  char const* message_;
+#include "s21_async.h"
+#include "s21_exception.h"
+#include "s21_memory.h"
+#include "s21_thread_pool.h"
 
+template <typename Derived>
+class S21MatExpr {
+  // Base of everything that can be evaluated element by element into an
+  // S21BasicMatrix: the matrix itself and the lazy nodes returned by +, -
+  // and scalar *, and views into a matrix. Every Derived provides
+  // value_type, get_rows(), get_cols() and Coeff(row, col)
  public:
-  // Constructor simply copies the message given to it to a fieild of a class
-  explicit CustomException(char const* msg) { message_ = msg; }
-  // What is default exception function that returns an explanatory string
-  char const* what() { return message_; }
+  const Derived& derived() const { return static_cast<const Derived&>(*this); }
 };
 
-class S21Matrix {
+template <typename Op, typename L, typename R>
+class S21MatBinaryExpr;
+template <typename E>
+class S21MatScaleExpr;
+template <typename T>
+class S21BasicLU;
+template <typename T>
+class S21BasicCholesky;
+template <typename T>
+class S21BasicQR;
+template <typename T>
+class S21BasicMatrixView;
+
+// Algorithm of S21BasicMatrix::Multiply: kAuto takes Strassen-Winograd
+// when every dimension is at least twice S21GetStrassenCrossover() and the
+// blocked GEMM otherwise. Strassen does fewer multiplications but its
+// rounding error grows faster with the size
+enum class S21MulAlgorithm { kAuto, kClassic, kStrassen };
+
+template <typename T>
+class S21BasicMatrix : public S21MatExpr<S21BasicMatrix<T>> {
+  // Dense matrix over the scalar type T. The library is built for float,
+  // double, long double and std::complex<double>; S21Matrix is the double one
+ public:
+  using value_type = T;
+
  private:
+  // Values are kept in one contiguous row-major block aligned to kAlignment
+  // bytes; element (i, j) lives at p_[i * cols_ + j], so cols_ is also the
+  // leading dimension (stride between rows). The block belongs to resource_
+  static constexpr std::size_t kAlignment = 64;
+
   int rows_, cols_;
-  double** p_;
+  T* p_;
+  std::pmr::memory_resource* resource_;
+
+  // Results derived from the current contents, kept while caching is on.
+  // Everything that can change the elements drops them (see set_caching())
+  struct Cache {
+    std::unique_ptr<S21BasicLU<T>> lu;
+    std::unique_ptr<S21BasicMatrix> inverse;
+  };
+  std::unique_ptr<Cache> cache_;
 
-  // Some hidden function, needed by CalcComplements()
-  int TwoDet() { return p_[0][0] * p_[1][1] - p_[0][1] * p_[1][0]; }
-  int OneDet() { return p_[0][0]; };
-  S21Matrix HandleMatrix(int ex_i, int ex_j);
+  // Allocation helpers for the storage block (memory is zero-initialized)
+  T* Allocate(int rows, int cols, bool zero = true) const;
+  void Deallocate(T* p, std::size_t size) const;
+  // Exchanges storage, sizes and resources with other; the cached results
+  // of both are dropped
+  void Swap(S21BasicMatrix& other);
+  std::size_t Size() const { return static_cast<std::size_t>(rows_) * cols_; }
+  T* RowPtr(int row) const {
+    return p_ + static_cast<std::size_t>(row) * cols_;
+  }
+  // Row check of the unchecked accessors, only done with
+  // S21_MATRIX_BOUNDS_CHECK
+  void CheckRow(int row) const {
+#ifdef S21_MATRIX_BOUNDS_CHECK
+    if (row >= rows_ || row < 0)
+      throw std::out_of_range("Incorrect input, index is out of range");
+#else
+    static_cast<void>(row);
+#endif
+  }
+
+  // Some hidden function, needed by CalcComplements() for singular matrices
+  S21BasicMatrix HandleMatrix(int ex_i, int ex_j);
+  // LU factorization of this matrix, see set_caching()
+  const S21BasicLU<T>& Factorize(std::optional<S21BasicLU<T>>& local);
+
+  // Expression interface: value of an element and a fused evaluation pass
+  T Coeff(int row, int col) const { return RowPtr(row)[col]; }
+  template <typename E, typename Op>
+  void EvalExpr(const E& expr, Op op);
+
+  friend class S21BasicLU<T>;
+  friend class S21BasicCholesky<T>;
+  friend class S21BasicQR<T>;
+  friend class S21BasicMatrixView<T>;
+  friend class S21BasicMatrixView<const T>;
+  template <typename, typename, typename>
+  friend class S21MatBinaryExpr;
+  template <typename>
+  friend class S21MatScaleExpr;
 
  public:
   // Constructors and destructor
-  S21Matrix();
-  S21Matrix(int rows, int cols);
-  S21Matrix(const S21Matrix& other);
-  S21Matrix(S21Matrix&& other);
-  ~S21Matrix();
+  S21BasicMatrix();
+  S21BasicMatrix(int rows, int cols);
+  // Takes the storage from the given resource instead of the current one
+  S21BasicMatrix(int rows, int cols, std::pmr::memory_resource* resource);
+  S21BasicMatrix(const S21BasicMatrix& other);
+  S21BasicMatrix(S21BasicMatrix&& other) noexcept;
+  // Evaluates an expression such as a + b - c * 2.0 in a single pass
+  template <typename E>
+  S21BasicMatrix(const S21MatExpr<E>& expr);
+  // Same for a temporary expression, which may hand over the block of a
+  // matrix moved into it (as in std::move(a) + b) instead of allocating
+  template <typename E>
+  S21BasicMatrix(S21MatExpr<E>&& expr);
+  ~S21BasicMatrix();
 
   // Accessors and mutators of rows_ and cols_ fields
-  int get_rows() { return rows_; };
-  int get_cols() { return cols_; };
+  int get_rows() const { return rows_; };
+  int get_cols() const { return cols_; };
+  std::pmr::memory_resource* get_resource() const { return resource_; }
   void set_rows(int rows);
   void set_cols(int cols);
 
   // Common matrix operations
-  bool EqMatrix(const S21Matrix& other);
-  void SumMatrix(const S21Matrix& other);
-  void SubMatrix(const S21Matrix& other);
-  void MulNumber(const double num);
-  void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose();
-  S21Matrix CalcComplements();
-  double Determinant();
-  S21Matrix InverseMatrix();
-
-  // Overloaded operators
-  double& operator()(int row, int col);
-  double& operator()(int row, int col) const;
-  bool operator==(const S21Matrix& other);
-  S21Matrix& operator=(const S21Matrix& other);
-  S21Matrix& operator+=(const S21Matrix& other);
-  S21Matrix operator+(const S21Matrix& other);
-  S21Matrix& operator-=(const S21Matrix& other);
-  S21Matrix operator-(const S21Matrix& other);
-  S21Matrix& operator*=(const S21Matrix& other);
-  S21Matrix operator*(const S21Matrix& other);
-  S21Matrix& operator*=(const double num);
-  friend S21Matrix operator*(double num, const S21Matrix& this_m);
-  friend S21Matrix operator*(const S21Matrix& this_m, double num);
+  bool EqMatrix(const S21BasicMatrix& other);
+  void SumMatrix(const S21BasicMatrix& other);
+  void SubMatrix(const S21BasicMatrix& other);
+  void MulNumber(const T num);
+  void MulMatrix(const S21BasicMatrixView<const T>& other);
+  S21BasicMatrix Transpose();
+  void TransposeInPlace();
+  S21BasicMatrix CalcComplements();
+  T Determinant();
+  S21BasicMatrix InverseMatrix();
+
+  // Opt-in caching of the LU factorization and the inverse, so that
+  // Determinant(), InverseMatrix() and CalcComplements() on an unchanged
+  // matrix reuse them (the inverse is still copied out). The cache is
+  // dropped by every mutating member, including the non-const element
+  // accessors, so read elements through a const reference to keep it.
+  // Writes through a view made earlier are not seen: call InvalidateCache()
+  // after them.
+  // Copies start without a cache, moves take it along with the contents
+  void set_caching(bool enable);
+  bool get_caching() const { return cache_ != nullptr; }
+  void InvalidateCache() {
+    if (cache_) {
+      cache_->lu.reset();
+      cache_->inverse.reset();
+    }
+  }
+
+  // Asynchronous versions of the operations above, run on the thread pool
+  // (see s21_async.h). The operands are copied first, so the caller may
+  // change or destroy them right away; a size mismatch throws here, errors
+  // found later are rethrown by Get() of the returned future
+  S21Future<S21BasicMatrix> MulMatrixAsync(const S21BasicMatrix& other) const;
+  S21Future<S21BasicMatrix> InverseMatrixAsync() const;
+  S21Future<T> DeterminantAsync() const;
+
+  // Views sharing the storage of this matrix (see S21BasicMatrixView). A
+  // const matrix only hands out read-only views; a writable one drops the
+  // cache, like the other non-const accessors
+  S21BasicMatrixView<T> Block(int row, int col, int rows, int cols);
+  S21BasicMatrixView<const T> Block(int row, int col, int rows,
+                                    int cols) const;
+  S21BasicMatrixView<T> Row(int row);
+  S21BasicMatrixView<const T> Row(int row) const;
+  S21BasicMatrixView<T> Col(int col);
+  S21BasicMatrixView<const T> Col(int col) const;
+  S21BasicMatrixView<T> Diagonal();
+  S21BasicMatrixView<const T> Diagonal() const;
+  S21BasicMatrixView<T> Strided(int row, int col, int rows, int cols,
+                                int row_step, int col_step);
+  S21BasicMatrixView<const T> Strided(int row, int col, int rows, int cols,
+                                      int row_step, int col_step) const;
+  // Product of two views (or matrices), computed straight from the strided
+  // storage without copying the operands
+  static S21BasicMatrix Multiply(
+      const S21BasicMatrixView<const T>& a,
+      const S21BasicMatrixView<const T>& b,
+      S21MulAlgorithm algorithm = S21MulAlgorithm::kAuto);
+
+  // Unchecked access for hot loops. The elements form one contiguous
+  // row-major block: begin()..end() visits all of them in order and m[i] is
+  // a pointer to row i, so m[i][j] is element (i, j). Row indices are only
+  // checked when S21_MATRIX_BOUNDS_CHECK is defined, e.g. in debug builds
+  T* data() {
+    InvalidateCache();
+    return p_;
+  }
+  const T* data() const { return p_; }
+  T* RowData(int row) {
+    CheckRow(row);
+    InvalidateCache();
+    return RowPtr(row);
+  }
+  const T* RowData(int row) const {
+    CheckRow(row);
+    return RowPtr(row);
+  }
+  T* operator[](int row) { return RowData(row); }
+  const T* operator[](int row) const { return RowData(row); }
+  T* begin() {
+    InvalidateCache();
+    return p_;
+  }
+  T* end() {
+    InvalidateCache();
+    return p_ + Size();
+  }
+  const T* begin() const { return p_; }
+  const T* end() const { return p_ + Size(); }
+  const T* cbegin() const { return p_; }
+  const T* cend() const { return p_ + Size(); }
+
+  // Overloaded operators. operator() always checks both indices and throws
+  // std::out_of_range
+  T& operator()(int row, int col);
+  const T& operator()(int row, int col) const;
+  bool operator==(const S21BasicMatrix& other);
+  S21BasicMatrix& operator=(const S21BasicMatrix& other);
+  // Takes the block of other when both resources are equal, otherwise
+  // copies into this matrix's own resource
+  S21BasicMatrix& operator=(S21BasicMatrix&& other);
+  template <typename E>
+  S21BasicMatrix& operator=(const S21MatExpr<E>& expr);
+  template <typename E>
+  S21BasicMatrix& operator=(S21MatExpr<E>&& expr);
+  S21BasicMatrix& operator+=(const S21BasicMatrix& other);
+  template <typename E>
+  S21BasicMatrix& operator+=(const S21MatExpr<E>& expr);
+  S21BasicMatrix& operator-=(const S21BasicMatrix& other);
+  template <typename E>
+  S21BasicMatrix& operator-=(const S21MatExpr<E>& expr);
+  S21BasicMatrix& operator*=(const S21BasicMatrix& other);
+  S21BasicMatrix operator*(const S21BasicMatrix& other) const;
+  S21BasicMatrix& operator*=(const T num);
 
   // Simple function for debug (never used in inmplementation)
   void PrintMatrix() {
-    for (int i = 0; i < rows_; ++i)
-      for (int j = 0; j < cols_; ++j) std::cout << p_[i][j] << std::endl;
+    for (std::size_t i = 0; i < Size(); ++i) std::cout << p_[i] << std::endl;
   }
 };
 
+using S21Matrix = S21BasicMatrix<double>;
+using S21MatrixF = S21BasicMatrix<float>;
+using S21MatrixLD = S21BasicMatrix<long double>;
+using S21MatrixC = S21BasicMatrix<std::complex<double>>;
+
+// Expressions and views returned by asynchronous tasks are evaluated into
+// a matrix before the operands they point to go away
+template <typename R>
+struct S21AsyncValue<
+    R, std::enable_if_t<std::is_base_of<S21MatExpr<R>, R>::value>> {
+  using type = S21BasicMatrix<typename R::value_type>;
+};
+
+template <typename T>
+class S21BasicMatrixView : public S21MatExpr<S21BasicMatrixView<T>> {
+  // Non-owning window into the storage of an S21BasicMatrix: element (i, j)
+  // of the view is p_[i * row_stride_ + j * col_stride_]. A view is cheap to
+  // copy, can be read as an operand of +, -, scalar * and the matrix product,
+  // and writes through to the parent. It must not outlive the parent or be
+  // used after the parent is resized. Assigning to a view is done element
+  // by element, so the right-hand side must not read parent elements that
+  // the view has already overwritten (e.g. an overlapping shifted block).
+  // S21BasicMatrixView<const T> is the read-only kind that const matrices
+  // hand out: it reads the same way, but writing through it does not
+  // compile. Every view converts to it
+ public:
+  using value_type = std::remove_const_t<T>;
+
+ private:
+  using Parent = std::conditional_t<std::is_const<T>::value,
+                                    const S21BasicMatrix<value_type>,
+                                    S21BasicMatrix<value_type>>;
+
+  T* p_;
+  int rows_, cols_;
+  std::ptrdiff_t row_stride_, col_stride_;
+
+  value_type Coeff(int row, int col) const {
+    return p_[row * row_stride_ + col * col_stride_];
+  }
+  template <typename E, typename Op>
+  S21BasicMatrixView& EvalExpr(const S21MatExpr<E>& expr, Op op);
+
+  friend class S21BasicMatrix<value_type>;
+  template <typename>
+  friend class S21BasicMatrixView;
+  template <typename, typename, typename>
+  friend class S21MatBinaryExpr;
+  template <typename>
+  friend class S21MatScaleExpr;
+
+ public:
+  S21BasicMatrixView(T* p, int rows, int cols, std::ptrdiff_t row_stride,
+                     std::ptrdiff_t col_stride)
+      : p_(p),
+        rows_(rows),
+        cols_(cols),
+        row_stride_(row_stride),
+        col_stride_(col_stride) {}
+  // The whole matrix as a view, a read-only one for a const matrix
+  S21BasicMatrixView(Parent& matrix)
+      : S21BasicMatrixView(matrix.p_, matrix.rows_, matrix.cols_,
+                           matrix.cols_, 1) {}
+  S21BasicMatrixView(const S21BasicMatrixView& other) = default;
+  // A writable view as a read-only one
+  template <typename U, typename = std::enable_if_t<
+                            std::is_same<const U, T>::value &&
+                            !std::is_same<U, T>::value>>
+  S21BasicMatrixView(const S21BasicMatrixView<U>& other)
+      : S21BasicMatrixView(other.data(), other.get_rows(), other.get_cols(),
+                           other.get_row_stride(), other.get_col_stride()) {}
+
+  int get_rows() const { return rows_; }
+  int get_cols() const { return cols_; }
+  std::ptrdiff_t get_row_stride() const { return row_stride_; }
+  std::ptrdiff_t get_col_stride() const { return col_stride_; }
+  T* data() const { return p_; }
+
+  // Sub-views, in coordinates of this view
+  S21BasicMatrixView Block(int row, int col, int rows, int cols) const {
+    return Strided(row, col, rows, cols, 1, 1);
+  }
+  S21BasicMatrixView Row(int row) const { return Block(row, 0, 1, cols_); }
+  S21BasicMatrixView Col(int col) const { return Block(0, col, rows_, 1); }
+  // Main diagonal as a column
+  S21BasicMatrixView Diagonal() const {
+    return {p_, rows_ < cols_ ? rows_ : cols_, 1, row_stride_ + col_stride_,
+            col_stride_};
+  }
+  // Every row_step-th row and col_step-th column of the rows x cols block
+  // that starts at (row, col)
+  S21BasicMatrixView Strided(int row, int col, int rows, int cols,
+                             int row_step, int col_step) const {
+    if (rows < 1 || cols < 1 || row_step < 1 || col_step < 1 || row < 0 ||
+        col < 0 || row + (rows - 1) * row_step >= rows_ ||
+        col + (cols - 1) * col_step >= cols_)
+      throw std::out_of_range("Incorrect input, view is out of range");
+    return {p_ + row * row_stride_ + col * col_stride_, rows, cols,
+            row_stride_ * row_step, col_stride_ * col_step};
+  }
+
+  T& operator()(int row, int col) const {
+    if (row >= rows_ || col >= cols_ || col < 0 || row < 0)
+      throw std::out_of_range("Incorrect input, index is out of range");
+    return p_[row * row_stride_ + col * col_stride_];
+  }
+
+  // Assignments write into the parent matrix
+  S21BasicMatrixView& operator=(const S21BasicMatrixView& other) {
+    return EvalExpr(other, [](T, T value) { return value; });
+  }
+  template <typename E>
+  S21BasicMatrixView& operator=(const S21MatExpr<E>& expr) {
+    return EvalExpr(expr, [](T, T value) { return value; });
+  }
+  template <typename E>
+  S21BasicMatrixView& operator+=(const S21MatExpr<E>& expr) {
+    return EvalExpr(expr, [](T a, T b) { return a + b; });
+  }
+  template <typename E>
+  S21BasicMatrixView& operator-=(const S21MatExpr<E>& expr) {
+    return EvalExpr(expr, [](T a, T b) { return a - b; });
+  }
+  S21BasicMatrixView& operator*=(const T num) {
+    return EvalExpr(*this, [num](T, T value) { return value * num; });
+  }
+};
+
+using S21MatrixView = S21BasicMatrixView<double>;
+
+// Lazy expression nodes. Operands that are lvalues are kept by reference,
+// temporaries are moved into the node, so a whole chain like a + b - c * 2.0
+// allocates nothing until it is assigned to a matrix, which then computes
+// every element in one pass over memory. A matrix moved into a chain even
+// lends its block to the result
+
+// Matrix owned by a temporary expression (moved into it), whose block the
+// result may take over; nullptr when every operand is held by reference
+template <typename T>
+S21BasicMatrix<T>* S21OwnedLeaf(S21BasicMatrix<T>& matrix) {
+  return &matrix;
+}
+
+template <typename T>
+S21BasicMatrix<T>* S21OwnedLeaf(const S21BasicMatrix<T>&) {
+  return nullptr;
+}
+
+template <typename T>
+S21BasicMatrix<std::remove_const_t<T>>* S21OwnedLeaf(
+    const S21BasicMatrixView<T>&) {
+  return nullptr;
+}
+
+template <typename E>
+S21BasicMatrix<typename E::value_type>* S21OwnedLeaf(const S21MatExpr<E>&) {
+  return nullptr;
+}
+
+template <typename E>
+S21BasicMatrix<typename E::value_type>* S21OwnedLeaf(S21MatExpr<E>& expr) {
+  return static_cast<E&>(expr).OwnedLeaf();
+}
+
+// Whether writing an expression element by element into the rows x cols
+// matrix block at p could read an element that is already overwritten:
+// some view in it overlaps the block with a mapping other than the block's
+// own, like a transpose or a shifted block. A matrix operand is either the
+// block itself, read at the index being written, or disjoint from it
+template <typename T>
+bool S21ExprAliases(const S21BasicMatrix<T>&, const T*, int, int) {
+  return false;
+}
+
+template <typename T>
+bool S21ExprAliases(const S21BasicMatrixView<T>& view,
+                    const std::remove_const_t<T>* p, int rows, int cols) {
+  std::ptrdiff_t row_stride = view.get_row_stride();
+  std::ptrdiff_t col_stride = view.get_col_stride();
+  if (view.data() == p && row_stride == cols && col_stride == 1) return false;
+  std::ptrdiff_t row_span = (view.get_rows() - 1) * row_stride;
+  std::ptrdiff_t col_span = (view.get_cols() - 1) * col_stride;
+  const T* first = view.data() + std::min<std::ptrdiff_t>(row_span, 0) +
+                   std::min<std::ptrdiff_t>(col_span, 0);
+  const T* last = view.data() + std::max<std::ptrdiff_t>(row_span, 0) +
+                  std::max<std::ptrdiff_t>(col_span, 0) + 1;
+  std::less<const std::remove_const_t<T>*> less;
+  return less(first, p + static_cast<std::size_t>(rows) * cols) &&
+         less(p, last);
+}
+
+template <typename E>
+bool S21ExprAliases(const S21MatExpr<E>& expr,
+                    const typename E::value_type* p, int rows, int cols) {
+  return expr.derived().Aliases(p, rows, cols);
+}
+
+template <typename T>
+using S21ExprOperand =
+    std::conditional_t<std::is_lvalue_reference<T>::value,
+                       const std::decay_t<T>&, std::decay_t<T>>;
+
+template <typename T>
+struct S21IsMatExpr
+    : std::is_base_of<S21MatExpr<std::decay_t<T>>, std::decay_t<T>> {};
+
+// Scalar type of an expression
+template <typename E>
+using S21ExprScalar = typename std::decay_t<E>::value_type;
+
+struct S21ExprAdd {
+  template <typename T>
+  static T Apply(T a, T b) {
+    return a + b;
+  }
+};
+
+struct S21ExprSub {
+  template <typename T>
+  static T Apply(T a, T b) {
+    return a - b;
+  }
+};
+
+template <typename Op, typename L, typename R>
+class S21MatBinaryExpr : public S21MatExpr<S21MatBinaryExpr<Op, L, R>> {
+  // Element-wise Op applied to two expressions of the same size
+ public:
+  using value_type = S21ExprScalar<L>;
+  static_assert(std::is_same<value_type, S21ExprScalar<R>>::value,
+                "Operands must have the same scalar type");
+
+ private:
+  L lhs_;
+  R rhs_;
+
+ public:
+  template <typename A, typename B>
+  S21MatBinaryExpr(A&& lhs, B&& rhs)
+      : lhs_(std::forward<A>(lhs)), rhs_(std::forward<B>(rhs)) {
+    if (lhs_.get_rows() != rhs_.get_rows() ||
+        lhs_.get_cols() != rhs_.get_cols())
+      throw CustomException("Different matrix dimensions");
+  }
+  int get_rows() const { return lhs_.get_rows(); }
+  int get_cols() const { return lhs_.get_cols(); }
+  value_type Coeff(int row, int col) const {
+    return Op::Apply(lhs_.Coeff(row, col), rhs_.Coeff(row, col));
+  }
+  S21BasicMatrix<value_type>* OwnedLeaf() {
+    S21BasicMatrix<value_type>* leaf = S21OwnedLeaf(lhs_);
+    return leaf ? leaf : S21OwnedLeaf(rhs_);
+  }
+  bool Aliases(const value_type* p, int rows, int cols) const {
+    return S21ExprAliases(lhs_, p, rows, cols) ||
+           S21ExprAliases(rhs_, p, rows, cols);
+  }
+};
+
+template <typename E>
+class S21MatScaleExpr : public S21MatExpr<S21MatScaleExpr<E>> {
+  // Expression multiplied by a number
+ public:
+  using value_type = S21ExprScalar<E>;
+
+ private:
+  E expr_;
+  value_type num_;
+
+ public:
+  template <typename A>
+  S21MatScaleExpr(A&& expr, value_type num)
+      : expr_(std::forward<A>(expr)), num_(num) {}
+  int get_rows() const { return expr_.get_rows(); }
+  int get_cols() const { return expr_.get_cols(); }
+  value_type Coeff(int row, int col) const {
+    return expr_.Coeff(row, col) * num_;
+  }
+  S21BasicMatrix<value_type>* OwnedLeaf() { return S21OwnedLeaf(expr_); }
+  bool Aliases(const value_type* p, int rows, int cols) const {
+    return S21ExprAliases(expr_, p, rows, cols);
+  }
+};
+
+template <typename L, typename R,
+          typename = std::enable_if_t<S21IsMatExpr<L>::value &&
+                                      S21IsMatExpr<R>::value>>
+S21MatBinaryExpr<S21ExprAdd, S21ExprOperand<L&&>, S21ExprOperand<R&&>>
+operator+(L&& lhs, R&& rhs) {
+  return {std::forward<L>(lhs), std::forward<R>(rhs)};
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<S21IsMatExpr<L>::value &&
+                                      S21IsMatExpr<R>::value>>
+S21MatBinaryExpr<S21ExprSub, S21ExprOperand<L&&>, S21ExprOperand<R&&>>
+operator-(L&& lhs, R&& rhs) {
+  return {std::forward<L>(lhs), std::forward<R>(rhs)};
+}
+
 // This functions needed to implement MulNumber() in any order relatively to
 // matrix (e.g. 2 * m and m * 2)
-S21Matrix operator*(double num, const S21Matrix& this_m);
-S21Matrix operator*(const S21Matrix& this_m, double num);
+template <typename E, typename = std::enable_if_t<S21IsMatExpr<E>::value>>
+S21MatScaleExpr<S21ExprOperand<E&&>> operator*(S21ExprScalar<E> num,
+                                               E&& expr) {
+  return {std::forward<E>(expr), num};
+}
+
+template <typename E, typename = std::enable_if_t<S21IsMatExpr<E>::value>>
+S21MatScaleExpr<S21ExprOperand<E&&>> operator*(E&& expr,
+                                               S21ExprScalar<E> num) {
+  return {std::forward<E>(expr), num};
+}
+
+// Matrix product of expressions: lazy operands are evaluated first, since
+// every element of a product depends on whole rows and columns
+template <typename T>
+const S21BasicMatrix<T>& S21EvalOperand(const S21BasicMatrix<T>& matrix) {
+  return matrix;
+}
+
+template <typename T>
+const S21BasicMatrixView<T>& S21EvalOperand(
+    const S21BasicMatrixView<T>& view) {
+  return view;
+}
+
+template <typename E>
+S21BasicMatrix<typename E::value_type> S21EvalOperand(
+    const S21MatExpr<E>& expr) {
+  return S21BasicMatrix<typename E::value_type>(expr);
+}
+
+template <typename L, typename R>
+S21BasicMatrix<typename L::value_type> operator*(const S21MatExpr<L>& lhs,
+                                                 const S21MatExpr<R>& rhs) {
+  // Matrices and views are passed to the kernel with their strides as they
+  // are, other expressions are evaluated into temporaries
+  using T = typename L::value_type;
+  const auto& a = S21EvalOperand(lhs.derived());
+  const auto& b = S21EvalOperand(rhs.derived());
+  return S21BasicMatrix<T>::Multiply(a, b);
+}
+
+template <typename T>
+template <typename E, typename Op>
+void S21BasicMatrix<T>::EvalExpr(const E& expr, Op op) {
+  // The fused pass: every element is computed by walking the expression tree
+  // once, bands of rows are spread over the thread pool. An expression that
+  // reads this block through another mapping is evaluated into a temporary
+  // first, which is then combined with the block in place
+  static_assert(std::is_same<T, typename E::value_type>::value,
+                "Operands must have the same scalar type");
+  if (S21ExprAliases(expr, p_, rows_, cols_))
+    return EvalExpr(S21BasicMatrix(expr), op);
+  InvalidateCache();
+  T* p = p_;
+  int cols = cols_;
+  S21ThreadPool::Instance().ParallelFor(
+      rows_, cols, [p, cols, &expr, op](std::size_t first, std::size_t last) {
+        for (int i = first; i < static_cast<int>(last); ++i) {
+          T* row = p + static_cast<std::size_t>(i) * cols;
+          for (int j = 0; j < cols; ++j) row[j] = op(row[j], expr.Coeff(i, j));
+        }
+      });
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>::S21BasicMatrix(const S21MatExpr<E>& expr)
+    : rows_(expr.derived().get_rows()),
+      cols_(expr.derived().get_cols()),
+      resource_(S21GetResource()) {
+  p_ = Allocate(rows_, cols_, false);
+  EvalExpr(expr.derived(), [](T, T value) { return value; });
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>::S21BasicMatrix(S21MatExpr<E>&& expr)
+    : rows_(expr.derived().get_rows()),
+      cols_(expr.derived().get_cols()),
+      resource_(S21GetResource()) {
+  // Element (i, j) of the result only depends on element (i, j) of every
+  // operand, so the result can be computed in place over an operand matrix
+  // that the expression owns, and then take its block over
+  E& e = static_cast<E&>(expr);
+  S21BasicMatrix* leaf = S21OwnedLeaf(e);
+  // A block from another resource (say an arena that ends first) is not
+  // taken, the result gets its own
+  if (leaf && !(*leaf->resource_ == *resource_)) leaf = nullptr;
+  if (!leaf) {
+    p_ = Allocate(rows_, cols_, false);
+  } else {
+    p_ = leaf->p_;
+    resource_ = leaf->resource_;
+  }
+  EvalExpr(e, [](T, T value) { return value; });
+  if (leaf) {
+    leaf->InvalidateCache();
+    leaf->p_ = nullptr;
+    leaf->rows_ = 0;
+    leaf->cols_ = 0;
+  }
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(const S21MatExpr<E>& expr) {
+  // An expression of the same size is written over the block in place
+  // (through a temporary if it reads the block through a view, see
+  // EvalExpr()). One of another size may still read this matrix, so it is
+  // evaluated into a fresh block from resource_ that replaces the old one
+  // afterwards
+  const E& e = expr.derived();
+  if (rows_ != e.get_rows() || cols_ != e.get_cols()) {
+    S21ScopedResource scope(resource_);
+    S21BasicMatrix res(e);
+    Swap(res);
+    return *this;
+  }
+  EvalExpr(e, [](T, T value) { return value; });
+  return *this;
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(S21MatExpr<E>&& expr) {
+  // A result of another size is built from the temporary in resource_,
+  // possibly over a block that was moved into it
+  const E& e = expr.derived();
+  if (rows_ != e.get_rows() || cols_ != e.get_cols()) {
+    S21ScopedResource scope(resource_);
+    S21BasicMatrix res(std::move(expr));
+    Swap(res);
+    return *this;
+  }
+  EvalExpr(e, [](T, T value) { return value; });
+  return *this;
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator+=(const S21MatExpr<E>& expr) {
+  const E& e = expr.derived();
+  if (rows_ != e.get_rows() || cols_ != e.get_cols())
+    throw CustomException("Different matrix dimensions");
+  EvalExpr(e, [](T a, T b) { return a + b; });
+  return *this;
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator-=(const S21MatExpr<E>& expr) {
+  const E& e = expr.derived();
+  if (rows_ != e.get_rows() || cols_ != e.get_cols())
+    throw CustomException("Different matrix dimensions");
+  EvalExpr(e, [](T a, T b) { return a - b; });
+  return *this;
+}
+
+template <typename T>
+template <typename E, typename Op>
+S21BasicMatrixView<T>& S21BasicMatrixView<T>::EvalExpr(
+    const S21MatExpr<E>& expr, Op op) {
+  // Same fused pass as for a matrix, writing through the strides
+  static_assert(!std::is_const<T>::value, "A read-only view is not written");
+  static_assert(std::is_same<value_type, typename E::value_type>::value,
+                "Operands must have the same scalar type");
+  const E& e = expr.derived();
+  if (rows_ != e.get_rows() || cols_ != e.get_cols())
+    throw CustomException("Different matrix dimensions");
+  S21ThreadPool::Instance().ParallelFor(
+      rows_, cols_, [this, &e, op](std::size_t first, std::size_t last) {
+        for (int i = first; i < static_cast<int>(last); ++i) {
+          T* row = p_ + i * row_stride_;
+          for (int j = 0; j < cols_; ++j)
+            row[j * col_stride_] = op(row[j * col_stride_], e.Coeff(i, j));
+        }
+      });
+  return *this;
+}
+
+template <typename T>
+S21BasicMatrixView<T> S21BasicMatrix<T>::Block(int row, int col, int rows,
+                                                int cols) {
+  InvalidateCache();
+  return S21BasicMatrixView<T>(*this).Block(row, col, rows, cols);
+}
+
+template <typename T>
+S21BasicMatrixView<const T> S21BasicMatrix<T>::Block(int row, int col,
+                                                      int rows,
+                                                      int cols) const {
+  return S21BasicMatrixView<const T>(*this).Block(row, col, rows, cols);
+}
+
+template <typename T>
+S21BasicMatrixView<T> S21BasicMatrix<T>::Row(int row) {
+  InvalidateCache();
+  return S21BasicMatrixView<T>(*this).Row(row);
+}
+
+template <typename T>
+S21BasicMatrixView<const T> S21BasicMatrix<T>::Row(int row) const {
+  return S21BasicMatrixView<const T>(*this).Row(row);
+}
+
+template <typename T>
+S21BasicMatrixView<T> S21BasicMatrix<T>::Col(int col) {
+  InvalidateCache();
+  return S21BasicMatrixView<T>(*this).Col(col);
+}
+
+template <typename T>
+S21BasicMatrixView<const T> S21BasicMatrix<T>::Col(int col) const {
+  return S21BasicMatrixView<const T>(*this).Col(col);
+}
+
+template <typename T>
+S21BasicMatrixView<T> S21BasicMatrix<T>::Diagonal() {
+  InvalidateCache();
+  return S21BasicMatrixView<T>(*this).Diagonal();
+}
+
+template <typename T>
+S21BasicMatrixView<const T> S21BasicMatrix<T>::Diagonal() const {
+  return S21BasicMatrixView<const T>(*this).Diagonal();
+}
+
+template <typename T>
+S21BasicMatrixView<T> S21BasicMatrix<T>::Strided(int row, int col, int rows,
+                                                  int cols, int row_step,
+                                                  int col_step) {
+  InvalidateCache();
+  return S21BasicMatrixView<T>(*this).Strided(row, col, rows, cols, row_step,
+                                              col_step);
+}
+
+template <typename T>
+S21BasicMatrixView<const T> S21BasicMatrix<T>::Strided(
+    int row, int col, int rows, int cols, int row_step, int col_step) const {
+  return S21BasicMatrixView<const T>(*this).Strided(row, col, rows, cols,
+                                                    row_step, col_step);
+}
+
+template <typename T>
+inline T& S21BasicMatrix<T>::operator()(int row, int col) {
+  // This operator is a mutator of matrix values. It is defined here so the
+  // checks can be inlined into the caller's loop
+  if (row >= rows_ || col >= cols_ || col < 0 || row < 0)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  InvalidateCache();
+  return RowPtr(row)[col];
+}
+
+template <typename T>
+inline const T& S21BasicMatrix<T>::operator()(int row, int col) const {
+  // This operator is an accessor of matrix values
+  if (row >= rows_ || col >= cols_ || col < 0 || row < 0)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  return RowPtr(row)[col];
+}
+
+template <typename T>
+class S21BasicLU {
+  // LU factorization with partial pivoting: P * A = L * U, where L is unit
+  // lower triangular and U is upper triangular. Both are packed into one
+  // matrix, so the factorization costs O(n^3) once and can then be reused for
+  // the determinant, the inverse and any number of right-hand sides
+ private:
+  S21BasicMatrix<T> lu_;
+  std::vector<int> perm_;  // perm_[i] is the row of A that became row i
+  int sign_;               // sign of the permutation (+1 or -1)
+  bool singular_;
+
+ public:
+  explicit S21BasicLU(const S21BasicMatrix<T>& matrix);
+
+  int get_size() const { return lu_.rows_; }
+  bool IsSingular() const { return singular_; }
+  T Determinant() const;
+  // Solves A * X = B for every column of B
+  S21BasicMatrix<T> Solve(const S21BasicMatrix<T>& b) const;
+  S21BasicMatrix<T> Inverse() const;
+};
+
+using S21LU = S21BasicLU<double>;
+
+// Solves the linear system A * X = B (B may hold several right-hand sides as
+// its columns)
+template <typename T>
+S21BasicMatrix<T> Solve(const S21BasicMatrix<T>& a,
+                        const S21BasicMatrix<T>& b) {
+  return S21BasicLU<T>(a).Solve(b);
+}
 
 #endif  // SRC_S21_MATRIX_OOP_H_
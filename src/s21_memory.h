@@ -0,0 +1,94 @@
+#ifndef SRC_S21_MEMORY_H_
+#define SRC_S21_MEMORY_H_
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+// Memory resources for matrix storage. Every S21Matrix remembers the
+// std::pmr::memory_resource its block came from; matrices created without
+// an explicit one take the current resource of the creating thread, which
+// is std::pmr::get_default_resource() unless a scope below overrides it
+
+// Resource used by new matrices on this thread
+std::pmr::memory_resource* S21GetResource();
+
+class S21ScopedResource {
+  // Makes a resource current on this thread for the lifetime of the object,
+  // then restores the previous one. Scopes nest
+ public:
+  explicit S21ScopedResource(std::pmr::memory_resource* resource);
+  S21ScopedResource(const S21ScopedResource&) = delete;
+  S21ScopedResource& operator=(const S21ScopedResource&) = delete;
+  ~S21ScopedResource();
+
+ private:
+  std::pmr::memory_resource* previous_;
+};
+
+class S21PoolResource : public std::pmr::memory_resource {
+  // Thread-safe size-class pool. Requests are rounded up to one of four
+  // classes per power of two (at most 25% waste) and freed blocks are kept on
+  // the free list of their class, so a long-running loop that keeps creating
+  // matrices of the same sizes stops reaching the upstream allocator and
+  // does not fragment its heap. Requests above max_block bytes go to the
+  // upstream directly. The pool must outlive every matrix allocated from it
+ public:
+  explicit S21PoolResource(
+      std::size_t max_block = std::size_t(1) << 26,
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+  S21PoolResource(const S21PoolResource&) = delete;
+  S21PoolResource& operator=(const S21PoolResource&) = delete;
+  ~S21PoolResource() override;
+
+  // Returns every cached free block to the upstream
+  void Trim();
+  // Bytes held on the free lists
+  std::size_t get_cached_bytes() const;
+
+ private:
+  static constexpr std::size_t kMinBlock = 64;
+  static constexpr std::size_t kAlignment = 64;
+  static constexpr int kClasses = 4 * 58;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  struct SizeClass {
+    std::mutex mutex;
+    FreeBlock* head = nullptr;
+    std::size_t count = 0;
+  };
+
+  static int ClassOf(std::size_t bytes);
+  static std::size_t ClassSize(int index);
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+
+  std::size_t max_block_;
+  std::pmr::memory_resource* upstream_;
+  mutable SizeClass classes_[kClasses];
+};
+
+class S21ArenaScope {
+  // Arena for temporaries: while the scope is alive every matrix created on
+  // this thread is carved out of one monotonic buffer, freeing is a no-op,
+  // and the whole buffer goes back to the previous resource at once when the
+  // scope ends. Matrices created inside must not outlive the scope
+ public:
+  explicit S21ArenaScope(std::size_t initial_size = std::size_t(1) << 20);
+  S21ArenaScope(const S21ArenaScope&) = delete;
+  S21ArenaScope& operator=(const S21ArenaScope&) = delete;
+
+  std::pmr::memory_resource* get_resource() { return &arena_; }
+
+ private:
+  std::pmr::monotonic_buffer_resource arena_;
+  S21ScopedResource scope_;
+};
+
+#endif  // SRC_S21_MEMORY_H_
@@ -0,0 +1,138 @@
+#ifndef SRC_S21_SOLVERS_H_
+#define SRC_S21_SOLVERS_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_sparse_matrix.h"
+
+// Solvers for A * X = B beyond the LU one in s21_matrix_oop.h. The direct
+// solvers factor A once in the constructor, so solving for another set of
+// right-hand sides only costs the triangular sweeps; every Solve() takes B
+// with one right-hand side per column and handles all of them in one pass
+
+template <typename T>
+class S21BasicCholesky {
+  // Cholesky factorization A = L * L^H of a Hermitian (for real types
+  // symmetric) positive definite matrix, L is lower triangular. About half
+  // the work of LU and needs no pivoting. Only the lower triangle of A is
+  // read
+ private:
+  S21BasicMatrix<T> l_;
+
+ public:
+  explicit S21BasicCholesky(const S21BasicMatrix<T>& matrix);
+
+  int get_size() const { return l_.get_rows(); }
+  // The factor L, zero above the diagonal
+  const S21BasicMatrix<T>& L() const { return l_; }
+  T Determinant() const;
+  S21BasicMatrix<T> Solve(const S21BasicMatrix<T>& b) const;
+};
+
+template <typename T>
+class S21BasicQR {
+  // Householder QR factorization A = Q * R of an m x n matrix with m >= n,
+  // Q has orthonormal columns and R is upper triangular. Solve() returns the
+  // least squares solution, the exact one for square matrices
+ private:
+  // The reflectors and R are kept in the transposed matrix, so column j of
+  // A (and reflector j) is the contiguous row j: R is stored in its lower
+  // triangle, the reflector vectors (without their leading 1) to the right
+  // of the diagonal
+  S21BasicMatrix<T> qr_;
+  std::vector<T> tau_;
+
+  // B = H_0^H * ... * H_{n-1}^H * B, that is Q^H * B, or Q * B when
+  // adjoint is false
+  void ApplyQ(S21BasicMatrix<T>& b, bool adjoint) const;
+
+ public:
+  explicit S21BasicQR(const S21BasicMatrix<T>& matrix);
+
+  int get_rows() const { return qr_.get_cols(); }
+  int get_cols() const { return qr_.get_rows(); }
+  // Thin factors: Q is m x n and R is n x n
+  S21BasicMatrix<T> Q() const;
+  S21BasicMatrix<T> R() const;
+  // Minimizes ||A * X - B|| for every column of B
+  S21BasicMatrix<T> Solve(const S21BasicMatrix<T>& b) const;
+};
+
+using S21Cholesky = S21BasicCholesky<double>;
+using S21QR = S21BasicQR<double>;
+
+class S21MixedLU {
+  // Mixed-precision solver for double systems: A is factored in float (half
+  // the memory traffic, twice the SIMD width) and every solution is refined
+  // to double accuracy with residuals computed in double, as LAPACK's dsgesv
+  // does. Refinement stalls once the condition number nears 1 / FLT_EPSILON;
+  // then, and when A does not fit in float or its float factor is singular,
+  // the solve falls back to a double LU made on first need
+ private:
+  S21Matrix a_;
+  std::unique_ptr<S21BasicLU<float>> lu_;  // null when float is unusable
+  double a_norm_;                          // infinity norm of A
+  mutable std::once_flag fallback_once_;
+  mutable std::unique_ptr<S21LU> fallback_;
+  // Set once fallback_ is made; read without taking the once_flag
+  mutable std::atomic<bool> used_fallback_{false};
+
+  const S21LU& Fallback() const;
+
+ public:
+  // Refinement steps allowed before the double fallback
+  static constexpr int kMaxIterations = 30;
+
+  explicit S21MixedLU(const S21Matrix& matrix);
+
+  int get_size() const { return a_.get_rows(); }
+  // True once a solve had to use the double factorization
+  bool UsedFallback() const { return used_fallback_; }
+  S21Matrix Solve(const S21Matrix& b) const;
+  S21Matrix Inverse() const;
+};
+
+// Settings of the iterative solvers
+struct S21IterativeOptions {
+  // Stops when ||B - A * X|| <= tolerance * ||B|| for every column
+  double tolerance = 1e-10;
+  int max_iterations = 1000;
+  // GMRES restarts after this many Arnoldi steps
+  int restart = 50;
+};
+
+template <typename T>
+struct S21IterativeResult {
+  S21BasicMatrix<T> x;
+  int iterations;   // largest count over the right-hand sides
+  double residual;  // largest relative residual norm
+  bool converged;
+};
+
+// Conjugate gradient for Hermitian positive definite A. All right-hand
+// sides advance together, so every iteration makes one matrix product with
+// a block of vectors instead of one product per column
+template <typename T>
+S21IterativeResult<T> S21ConjugateGradient(
+    const S21BasicMatrix<T>& a, const S21BasicMatrix<T>& b,
+    const S21IterativeOptions& options = S21IterativeOptions());
+template <typename T>
+S21IterativeResult<T> S21ConjugateGradient(
+    const S21BasicSparseMatrix<T>& a, const S21BasicMatrix<T>& b,
+    const S21IterativeOptions& options = S21IterativeOptions());
+
+// Restarted GMRES for any non-singular A, one column of B at a time
+template <typename T>
+S21IterativeResult<T> S21Gmres(
+    const S21BasicMatrix<T>& a, const S21BasicMatrix<T>& b,
+    const S21IterativeOptions& options = S21IterativeOptions());
+template <typename T>
+S21IterativeResult<T> S21Gmres(
+    const S21BasicSparseMatrix<T>& a, const S21BasicMatrix<T>& b,
+    const S21IterativeOptions& options = S21IterativeOptions());
+
+#endif  // SRC_S21_SOLVERS_H_
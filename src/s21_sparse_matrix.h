@@ -0,0 +1,96 @@
+#ifndef SRC_S21_SPARSE_MATRIX_H_
+#define SRC_S21_SPARSE_MATRIX_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Compressed storage orders: by rows (CSR) or by columns (CSC)
+enum class S21SparseFormat { kCsr, kCsc };
+
+// One (row, col, value) entry used to build a sparse matrix
+template <typename T>
+struct S21Triplet {
+  int row, col;
+  T value;
+};
+
+template <typename T>
+class S21BasicSparseMatrix {
+  // Sparse companion of S21BasicMatrix that stores only the non-zero values.
+  // In CSR, entries of row i are values_[ptr_[i] .. ptr_[i + 1]) and idx_
+  // holds their columns, sorted; CSC is the same with rows and columns
+  // swapped. A CSR matrix read as CSC is its transpose, so transposing
+  // never moves the entries. Products and sums over CSR rows run on the
+  // thread pool; CSC products scatter into the result and run serially
+ public:
+  using value_type = T;
+
+ private:
+  int rows_, cols_;
+  S21SparseFormat format_;
+  std::vector<std::size_t> ptr_;  // major_count + 1 offsets
+  std::vector<int> idx_;          // minor index of every entry
+  std::vector<T> values_;
+
+  // Rows in CSR and columns in CSC, and the other dimension
+  int MajorCount() const {
+    return format_ == S21SparseFormat::kCsr ? rows_ : cols_;
+  }
+  int MinorCount() const {
+    return format_ == S21SparseFormat::kCsr ? cols_ : rows_;
+  }
+  // Builds the compressed arrays from entries sorted by (major, minor),
+  // summing duplicates and dropping zeroes
+  void Compress(std::vector<S21Triplet<T>>& entries);
+
+ public:
+  // Empty (all zero) matrix
+  S21BasicSparseMatrix(int rows, int cols,
+                       S21SparseFormat format = S21SparseFormat::kCsr);
+  // Duplicated positions are summed
+  S21BasicSparseMatrix(int rows, int cols,
+                       const std::vector<S21Triplet<T>>& triplets,
+                       S21SparseFormat format = S21SparseFormat::kCsr);
+  // Keeps the elements of dense whose absolute value is above eps
+  explicit S21BasicSparseMatrix(const S21BasicMatrix<T>& dense,
+                                S21SparseFormat format = S21SparseFormat::kCsr,
+                                double eps = 0);
+
+  int get_rows() const { return rows_; }
+  int get_cols() const { return cols_; }
+  S21SparseFormat get_format() const { return format_; }
+  // Number of stored entries
+  std::size_t get_nnz() const { return values_.size(); }
+
+  // Element (row, col), zero when it is not stored
+  T operator()(int row, int col) const;
+
+  // Same matrix in the other storage order (a counting sort, O(nnz))
+  S21BasicSparseMatrix ToFormat(S21SparseFormat format) const;
+  // Transpose as a copy, and in place in O(1): only the format changes
+  S21BasicSparseMatrix Transpose() const;
+  void TransposeInPlace();
+  S21BasicMatrix<T> ToDense() const;
+
+  // Sparse x dense vector (SpMV) and sparse x dense matrix (SpMM)
+  std::vector<T> Multiply(const std::vector<T>& x) const;
+  S21BasicMatrix<T> Multiply(const S21BasicMatrix<T>& b) const;
+  // Element-wise sum, in the format of this matrix
+  S21BasicSparseMatrix Add(const S21BasicSparseMatrix& other) const;
+
+  std::vector<T> operator*(const std::vector<T>& x) const {
+    return Multiply(x);
+  }
+  S21BasicMatrix<T> operator*(const S21BasicMatrix<T>& b) const {
+    return Multiply(b);
+  }
+  S21BasicSparseMatrix operator+(const S21BasicSparseMatrix& other) const {
+    return Add(other);
+  }
+};
+
+using S21SparseMatrix = S21BasicSparseMatrix<double>;
+
+#endif  // SRC_S21_SPARSE_MATRIX_H_
@@ -0,0 +1,73 @@
+#ifndef SRC_S21_THREAD_POOL_H_
+#define SRC_S21_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class S21ThreadPool {
+  // Persistent work-stealing thread pool used as the parallel backend of
+  // S21Matrix. Every worker owns a task deque: it pops its own tasks from the
+  // back and steals from the front of the others when it runs dry. The pool
+  // is started lazily with one worker per hardware thread (or
+  // S21_MATRIX_THREADS if set); a thread count of 1 makes everything serial
+ public:
+  using Task = std::function<void()>;
+  // Body of a parallel loop, called for half-open ranges [begin, end)
+  using RangeBody = std::function<void(std::size_t, std::size_t)>;
+
+  static S21ThreadPool& Instance();
+
+  S21ThreadPool(const S21ThreadPool&) = delete;
+  S21ThreadPool& operator=(const S21ThreadPool&) = delete;
+  ~S21ThreadPool();
+
+  // Number of threads taking part in parallel loops (caller included)
+  int get_thread_count() const { return thread_count_; }
+  // Restarts the pool with the given number of threads, 0 means one per
+  // hardware thread. Must not be called while parallel work is running
+  void set_thread_count(int count);
+  // Loops with less total work than this (roughly in element operations)
+  // run serially on the calling thread
+  std::size_t get_serial_threshold() const { return serial_threshold_; }
+  void set_serial_threshold(std::size_t work) { serial_threshold_ = work; }
+
+  // Queues a task to be executed by some worker
+  void Submit(Task task);
+  // Splits [0, n) into chunks and runs them on the pool, the calling thread
+  // takes part too. work_per_item estimates the cost of one item and is
+  // compared with the serial threshold. The first exception thrown by the
+  // body is rethrown here once every chunk is finished
+  void ParallelFor(std::size_t n, std::size_t work_per_item,
+                   const RangeBody& body);
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  S21ThreadPool();
+  void Start(int count);
+  void Stop();
+  void WorkerLoop(std::size_t index);
+  bool TryPop(std::size_t index, Task& task);
+
+  int thread_count_;
+  std::size_t serial_threshold_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  std::atomic<std::size_t> next_queue_;
+  std::atomic<std::size_t> pending_;
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  bool stop_;
+};
+
+#endif  // SRC_S21_THREAD_POOL_H_
@@ -0,0 +1,576 @@
+#include "s21_kernels.h"
+
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define S21_X86 1
+#endif
+
+namespace {
+
+// ---------------------------------------------------------------- scalar --
+
+template <typename T>
+void AddScalar(T* dst, const T* src, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) dst[i] += src[i];
+}
+
+template <typename T>
+void SubScalar(T* dst, const T* src, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) dst[i] -= src[i];
+}
+
+template <typename T>
+void ScaleScalar(T* dst, T num, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) dst[i] *= num;
+}
+
+template <typename T>
+bool EqualScalar(const T* a, const T* b, std::size_t n, double eps) {
+  for (std::size_t i = 0; i < n; ++i)
+    if (std::abs(a[i] - b[i]) > eps) return false;
+  return true;
+}
+
+// Stores a register tile that was spilled to acc into an mr x nr corner of C
+template <typename T>
+void StoreTile(const T (*acc)[kS21GemmNr], T* c, std::ptrdiff_t ldc, int mr,
+               int nr, bool accumulate) {
+  for (int i = 0; i < mr; ++i) {
+    T* c_row = c + i * ldc;
+    if (accumulate)
+      for (int j = 0; j < nr; ++j) c_row[j] += acc[i][j];
+    else
+      for (int j = 0; j < nr; ++j) c_row[j] = acc[i][j];
+  }
+}
+
+template <typename T>
+void MicroKernelScalar(int kc, const T* __restrict a, const T* __restrict b,
+                       T* c, std::ptrdiff_t ldc, int mr, int nr,
+                       bool accumulate) {
+  T acc[kS21GemmMr][kS21GemmNr] = {};
+  for (int p = 0; p < kc; ++p, a += kS21GemmMr, b += kS21GemmNr)
+    for (int i = 0; i < kS21GemmMr; ++i)
+      for (int j = 0; j < kS21GemmNr; ++j) acc[i][j] += a[i] * b[j];
+  StoreTile(acc, c, ldc, mr, nr, accumulate);
+}
+
+#ifdef S21_X86
+
+// ------------------------------------------------------------------ SSE2 --
+
+void AddSse2(double* dst, const double* src, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm_storeu_pd(dst + i,
+                  _mm_add_pd(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i)));
+  for (; i < n; ++i) dst[i] += src[i];
+}
+
+void SubSse2(double* dst, const double* src, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm_storeu_pd(dst + i,
+                  _mm_sub_pd(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i)));
+  for (; i < n; ++i) dst[i] -= src[i];
+}
+
+void ScaleSse2(double* dst, double num, std::size_t n) {
+  __m128d k = _mm_set1_pd(num);
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm_storeu_pd(dst + i, _mm_mul_pd(_mm_loadu_pd(dst + i), k));
+  for (; i < n; ++i) dst[i] *= num;
+}
+
+bool EqualSse2(const double* a, const double* b, std::size_t n, double eps) {
+  // |a - b| is taken by clearing the sign bit; the mismatch masks of a whole
+  // block are OR-ed together so there is one branch per 8 elements
+  __m128d abs_mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+  __m128d e = _mm_set1_pd(eps);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128d m = _mm_setzero_pd();
+    for (int v = 0; v < 8; v += 2) {
+      __m128d d = _mm_sub_pd(_mm_loadu_pd(a + i + v), _mm_loadu_pd(b + i + v));
+      m = _mm_or_pd(m, _mm_cmpgt_pd(_mm_and_pd(d, abs_mask), e));
+    }
+    if (_mm_movemask_pd(m)) return false;
+  }
+  return EqualScalar<double>(a + i, b + i, n - i, eps);
+}
+
+// ------------------------------------------------------------- AVX2+FMA --
+
+__attribute__((target("avx2,fma"))) void AddAvx2(double* dst,
+                                                 const double* src,
+                                                 std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_loadu_pd(dst + i),
+                                            _mm256_loadu_pd(src + i)));
+  for (; i < n; ++i) dst[i] += src[i];
+}
+
+__attribute__((target("avx2,fma"))) void SubAvx2(double* dst,
+                                                 const double* src,
+                                                 std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(dst + i, _mm256_sub_pd(_mm256_loadu_pd(dst + i),
+                                            _mm256_loadu_pd(src + i)));
+  for (; i < n; ++i) dst[i] -= src[i];
+}
+
+__attribute__((target("avx2,fma"))) void ScaleAvx2(double* dst, double num,
+                                                   std::size_t n) {
+  __m256d k = _mm256_set1_pd(num);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm256_storeu_pd(dst + i, _mm256_mul_pd(_mm256_loadu_pd(dst + i), k));
+  for (; i < n; ++i) dst[i] *= num;
+}
+
+__attribute__((target("avx2,fma"))) bool EqualAvx2(const double* a,
+                                                   const double* b,
+                                                   std::size_t n, double eps) {
+  __m256d abs_mask =
+      _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+  __m256d e = _mm256_set1_pd(eps);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256d m = _mm256_setzero_pd();
+    for (int v = 0; v < 16; v += 4) {
+      __m256d d =
+          _mm256_sub_pd(_mm256_loadu_pd(a + i + v), _mm256_loadu_pd(b + i + v));
+      m = _mm256_or_pd(
+          m, _mm256_cmp_pd(_mm256_and_pd(d, abs_mask), e, _CMP_GT_OQ));
+    }
+    if (_mm256_movemask_pd(m)) return false;
+  }
+  return EqualScalar<double>(a + i, b + i, n - i, eps);
+}
+
+__attribute__((target("avx2,fma"))) void MicroKernelAvx2(
+    int kc, const double* __restrict a, const double* __restrict b, double* c,
+    std::ptrdiff_t ldc, int mr, int nr, bool accumulate) {
+  // 4 x 8 tile in eight ymm accumulators, one FMA per broadcast A value
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  for (int p = 0; p < kc; ++p, a += kS21GemmMr, b += kS21GemmNr) {
+    __m256d b0 = _mm256_loadu_pd(b), b1 = _mm256_loadu_pd(b + 4);
+    __m256d ai = _mm256_broadcast_sd(a);
+    c00 = _mm256_fmadd_pd(ai, b0, c00);
+    c01 = _mm256_fmadd_pd(ai, b1, c01);
+    ai = _mm256_broadcast_sd(a + 1);
+    c10 = _mm256_fmadd_pd(ai, b0, c10);
+    c11 = _mm256_fmadd_pd(ai, b1, c11);
+    ai = _mm256_broadcast_sd(a + 2);
+    c20 = _mm256_fmadd_pd(ai, b0, c20);
+    c21 = _mm256_fmadd_pd(ai, b1, c21);
+    ai = _mm256_broadcast_sd(a + 3);
+    c30 = _mm256_fmadd_pd(ai, b0, c30);
+    c31 = _mm256_fmadd_pd(ai, b1, c31);
+  }
+  double acc[kS21GemmMr][kS21GemmNr];
+  _mm256_storeu_pd(acc[0], c00);
+  _mm256_storeu_pd(acc[0] + 4, c01);
+  _mm256_storeu_pd(acc[1], c10);
+  _mm256_storeu_pd(acc[1] + 4, c11);
+  _mm256_storeu_pd(acc[2], c20);
+  _mm256_storeu_pd(acc[2] + 4, c21);
+  _mm256_storeu_pd(acc[3], c30);
+  _mm256_storeu_pd(acc[3] + 4, c31);
+  StoreTile(acc, c, ldc, mr, nr, accumulate);
+}
+
+// --------------------------------------------------------------- AVX-512 --
+
+__attribute__((target("avx512f"))) void AddAvx512(double* dst,
+                                                  const double* src,
+                                                  std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(dst + i, _mm512_add_pd(_mm512_loadu_pd(dst + i),
+                                            _mm512_loadu_pd(src + i)));
+  if (i < n) {
+    __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(dst + i, tail,
+                          _mm512_add_pd(_mm512_maskz_loadu_pd(tail, dst + i),
+                                        _mm512_maskz_loadu_pd(tail, src + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void SubAvx512(double* dst,
+                                                  const double* src,
+                                                  std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(dst + i, _mm512_sub_pd(_mm512_loadu_pd(dst + i),
+                                            _mm512_loadu_pd(src + i)));
+  if (i < n) {
+    __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(dst + i, tail,
+                          _mm512_sub_pd(_mm512_maskz_loadu_pd(tail, dst + i),
+                                        _mm512_maskz_loadu_pd(tail, src + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512(double* dst, double num,
+                                                    std::size_t n) {
+  __m512d k = _mm512_set1_pd(num);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(dst + i, _mm512_mul_pd(_mm512_loadu_pd(dst + i), k));
+  if (i < n) {
+    __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+    __m512d v = _mm512_maskz_loadu_pd(tail, dst + i);
+    _mm512_mask_storeu_pd(dst + i, tail, _mm512_mul_pd(v, k));
+  }
+}
+
+__attribute__((target("avx512f"))) bool EqualAvx512(const double* a,
+                                                    const double* b,
+                                                    std::size_t n,
+                                                    double eps) {
+  __m512d e = _mm512_set1_pd(eps);
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __mmask8 m = 0;
+    for (int v = 0; v < 32; v += 8) {
+      __m512d d =
+          _mm512_sub_pd(_mm512_loadu_pd(a + i + v), _mm512_loadu_pd(b + i + v));
+      m |= _mm512_cmp_pd_mask(_mm512_abs_pd(d), e, _CMP_GT_OQ);
+    }
+    if (m) return false;
+  }
+  return EqualScalar<double>(a + i, b + i, n - i, eps);
+}
+
+__attribute__((target("avx512f"))) void MicroKernelAvx512(
+    int kc, const double* __restrict a, const double* __restrict b, double* c,
+    std::ptrdiff_t ldc, int mr, int nr, bool accumulate) {
+  // One zmm register holds a whole 8-wide row of the tile
+  __m512d c0 = _mm512_setzero_pd(), c1 = _mm512_setzero_pd();
+  __m512d c2 = _mm512_setzero_pd(), c3 = _mm512_setzero_pd();
+  for (int p = 0; p < kc; ++p, a += kS21GemmMr, b += kS21GemmNr) {
+    __m512d bv = _mm512_loadu_pd(b);
+    c0 = _mm512_fmadd_pd(_mm512_set1_pd(a[0]), bv, c0);
+    c1 = _mm512_fmadd_pd(_mm512_set1_pd(a[1]), bv, c1);
+    c2 = _mm512_fmadd_pd(_mm512_set1_pd(a[2]), bv, c2);
+    c3 = _mm512_fmadd_pd(_mm512_set1_pd(a[3]), bv, c3);
+  }
+  if (mr == kS21GemmMr && nr == kS21GemmNr) {
+    __m512d* rows[] = {&c0, &c1, &c2, &c3};
+    for (int i = 0; i < kS21GemmMr; ++i) {
+      double* c_row = c + i * ldc;
+      __m512d v = *rows[i];
+      if (accumulate) v = _mm512_add_pd(v, _mm512_loadu_pd(c_row));
+      _mm512_storeu_pd(c_row, v);
+    }
+    return;
+  }
+  double acc[kS21GemmMr][kS21GemmNr];
+  _mm512_storeu_pd(acc[0], c0);
+  _mm512_storeu_pd(acc[1], c1);
+  _mm512_storeu_pd(acc[2], c2);
+  _mm512_storeu_pd(acc[3], c3);
+  StoreTile(acc, c, ldc, mr, nr, accumulate);
+}
+
+// ------------------------------------------------------- float versions --
+// Same kernels for single precision: twice as many values per register
+
+void AddSse2F(float* dst, const float* src, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i,
+                  _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+  for (; i < n; ++i) dst[i] += src[i];
+}
+
+void SubSse2F(float* dst, const float* src, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i,
+                  _mm_sub_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+  for (; i < n; ++i) dst[i] -= src[i];
+}
+
+void ScaleSse2F(float* dst, float num, std::size_t n) {
+  __m128 k = _mm_set1_ps(num);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(dst + i), k));
+  for (; i < n; ++i) dst[i] *= num;
+}
+
+bool EqualSse2F(const float* a, const float* b, std::size_t n, double eps) {
+  __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  __m128 e = _mm_set1_ps(static_cast<float>(eps));
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128 m = _mm_setzero_ps();
+    for (int v = 0; v < 16; v += 4) {
+      __m128 d = _mm_sub_ps(_mm_loadu_ps(a + i + v), _mm_loadu_ps(b + i + v));
+      m = _mm_or_ps(m, _mm_cmpgt_ps(_mm_and_ps(d, abs_mask), e));
+    }
+    if (_mm_movemask_ps(m)) return false;
+  }
+  return EqualScalar<float>(a + i, b + i, n - i, eps);
+}
+
+__attribute__((target("avx2,fma"))) void AddAvx2F(float* dst,
+                                                  const float* src,
+                                                  std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i),
+                                            _mm256_loadu_ps(src + i)));
+  for (; i < n; ++i) dst[i] += src[i];
+}
+
+__attribute__((target("avx2,fma"))) void SubAvx2F(float* dst,
+                                                  const float* src,
+                                                  std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_sub_ps(_mm256_loadu_ps(dst + i),
+                                            _mm256_loadu_ps(src + i)));
+  for (; i < n; ++i) dst[i] -= src[i];
+}
+
+__attribute__((target("avx2,fma"))) void ScaleAvx2F(float* dst, float num,
+                                                    std::size_t n) {
+  __m256 k = _mm256_set1_ps(num);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(dst + i), k));
+  for (; i < n; ++i) dst[i] *= num;
+}
+
+__attribute__((target("avx2,fma"))) bool EqualAvx2F(const float* a,
+                                                    const float* b,
+                                                    std::size_t n,
+                                                    double eps) {
+  __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  __m256 e = _mm256_set1_ps(static_cast<float>(eps));
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256 m = _mm256_setzero_ps();
+    for (int v = 0; v < 32; v += 8) {
+      __m256 d =
+          _mm256_sub_ps(_mm256_loadu_ps(a + i + v), _mm256_loadu_ps(b + i + v));
+      m = _mm256_or_ps(
+          m, _mm256_cmp_ps(_mm256_and_ps(d, abs_mask), e, _CMP_GT_OQ));
+    }
+    if (_mm256_movemask_ps(m)) return false;
+  }
+  return EqualScalar<float>(a + i, b + i, n - i, eps);
+}
+
+__attribute__((target("avx2,fma"))) void MicroKernelAvx2F(
+    int kc, const float* __restrict a, const float* __restrict b, float* c,
+    std::ptrdiff_t ldc, int mr, int nr, bool accumulate) {
+  // A whole 8-wide row of the tile fits one ymm register. AVX-512 machines
+  // use this kernel too, the tile is too narrow for zmm registers
+  __m256 c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps();
+  __m256 c2 = _mm256_setzero_ps(), c3 = _mm256_setzero_ps();
+  for (int p = 0; p < kc; ++p, a += kS21GemmMr, b += kS21GemmNr) {
+    __m256 bv = _mm256_loadu_ps(b);
+    c0 = _mm256_fmadd_ps(_mm256_broadcast_ss(a), bv, c0);
+    c1 = _mm256_fmadd_ps(_mm256_broadcast_ss(a + 1), bv, c1);
+    c2 = _mm256_fmadd_ps(_mm256_broadcast_ss(a + 2), bv, c2);
+    c3 = _mm256_fmadd_ps(_mm256_broadcast_ss(a + 3), bv, c3);
+  }
+  float acc[kS21GemmMr][kS21GemmNr];
+  _mm256_storeu_ps(acc[0], c0);
+  _mm256_storeu_ps(acc[1], c1);
+  _mm256_storeu_ps(acc[2], c2);
+  _mm256_storeu_ps(acc[3], c3);
+  StoreTile(acc, c, ldc, mr, nr, accumulate);
+}
+
+__attribute__((target("avx512f"))) void AddAvx512F(float* dst,
+                                                   const float* src,
+                                                   std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_add_ps(_mm512_loadu_ps(dst + i),
+                                            _mm512_loadu_ps(src + i)));
+  if (i < n) {
+    __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_ps(dst + i, tail,
+                          _mm512_add_ps(_mm512_maskz_loadu_ps(tail, dst + i),
+                                        _mm512_maskz_loadu_ps(tail, src + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void SubAvx512F(float* dst,
+                                                   const float* src,
+                                                   std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_sub_ps(_mm512_loadu_ps(dst + i),
+                                            _mm512_loadu_ps(src + i)));
+  if (i < n) {
+    __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_ps(dst + i, tail,
+                          _mm512_sub_ps(_mm512_maskz_loadu_ps(tail, dst + i),
+                                        _mm512_maskz_loadu_ps(tail, src + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512F(float* dst, float num,
+                                                     std::size_t n) {
+  __m512 k = _mm512_set1_ps(num);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_loadu_ps(dst + i), k));
+  if (i < n) {
+    __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+    __m512 v = _mm512_maskz_loadu_ps(tail, dst + i);
+    _mm512_mask_storeu_ps(dst + i, tail, _mm512_mul_ps(v, k));
+  }
+}
+
+__attribute__((target("avx512f"))) bool EqualAvx512F(const float* a,
+                                                     const float* b,
+                                                     std::size_t n,
+                                                     double eps) {
+  __m512 e = _mm512_set1_ps(static_cast<float>(eps));
+  std::size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    __mmask16 m = 0;
+    for (int v = 0; v < 64; v += 16) {
+      __m512 d =
+          _mm512_sub_ps(_mm512_loadu_ps(a + i + v), _mm512_loadu_ps(b + i + v));
+      m |= _mm512_cmp_ps_mask(_mm512_abs_ps(d), e, _CMP_GT_OQ);
+    }
+    if (m) return false;
+  }
+  return EqualScalar<float>(a + i, b + i, n - i, eps);
+}
+
+#endif  // S21_X86
+
+template <typename T>
+const S21SimdKernels<T> kScalarKernels = {AddScalar<T>, SubScalar<T>,
+                                          ScaleScalar<T>, EqualScalar<T>,
+                                          MicroKernelScalar<T>};
+#ifdef S21_X86
+// SSE2 has no FMA, the scalar micro-kernel is auto-vectorized with it anyway
+const S21SimdKernels<double> kSse2Kernels = {
+    AddSse2, SubSse2, ScaleSse2, EqualSse2, MicroKernelScalar<double>};
+const S21SimdKernels<double> kAvx2Kernels = {AddAvx2, SubAvx2, ScaleAvx2,
+                                             EqualAvx2, MicroKernelAvx2};
+const S21SimdKernels<double> kAvx512Kernels = {
+    AddAvx512, SubAvx512, ScaleAvx512, EqualAvx512, MicroKernelAvx512};
+const S21SimdKernels<float> kSse2KernelsF = {
+    AddSse2F, SubSse2F, ScaleSse2F, EqualSse2F, MicroKernelScalar<float>};
+const S21SimdKernels<float> kAvx2KernelsF = {AddAvx2F, SubAvx2F, ScaleAvx2F,
+                                             EqualAvx2F, MicroKernelAvx2F};
+const S21SimdKernels<float> kAvx512KernelsF = {
+    AddAvx512F, SubAvx512F, ScaleAvx512F, EqualAvx512F, MicroKernelAvx2F};
+#endif
+
+// Kernel table of the given level for every scalar type; types without
+// hand-written kernels always get the portable ones
+template <typename T>
+const S21SimdKernels<T>* KernelsFor(const T*, S21SimdLevel) {
+  return &kScalarKernels<T>;
+}
+
+const S21SimdKernels<double>* KernelsFor(const double*, S21SimdLevel level) {
+#ifdef S21_X86
+  switch (level) {
+    case S21SimdLevel::kAvx512:
+      return &kAvx512Kernels;
+    case S21SimdLevel::kAvx2:
+      return &kAvx2Kernels;
+    case S21SimdLevel::kSse2:
+      return &kSse2Kernels;
+    default:
+      break;
+  }
+#endif
+  (void)level;
+  return &kScalarKernels<double>;
+}
+
+const S21SimdKernels<float>* KernelsFor(const float*, S21SimdLevel level) {
+#ifdef S21_X86
+  switch (level) {
+    case S21SimdLevel::kAvx512:
+      return &kAvx512KernelsF;
+    case S21SimdLevel::kAvx2:
+      return &kAvx2KernelsF;
+    case S21SimdLevel::kSse2:
+      return &kSse2KernelsF;
+    default:
+      break;
+  }
+#endif
+  (void)level;
+  return &kScalarKernels<float>;
+}
+
+std::atomic<S21SimdLevel>& ActiveLevel() {
+  // The level is detected once; S21SetSimdLevel() can lower it later
+  static std::atomic<S21SimdLevel> active(S21DetectSimdLevel());
+  return active;
+}
+
+}  // namespace
+
+S21SimdLevel S21DetectSimdLevel() {
+  // Picks the best instruction set supported by the running CPU. The
+  // S21_MATRIX_SIMD environment variable (scalar, sse2, avx2, avx512) can cap
+  // it, which is handy for comparing kernels on one machine
+  S21SimdLevel level = S21SimdLevel::kScalar;
+#ifdef S21_X86
+  __builtin_cpu_init();
+  level = S21SimdLevel::kSse2;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    level = S21SimdLevel::kAvx2;
+  if (__builtin_cpu_supports("avx512f")) level = S21SimdLevel::kAvx512;
+#endif
+  const char* env = std::getenv("S21_MATRIX_SIMD");
+  if (env) {
+    S21SimdLevel cap = level;
+    if (!std::strcmp(env, "scalar")) cap = S21SimdLevel::kScalar;
+    if (!std::strcmp(env, "sse2")) cap = S21SimdLevel::kSse2;
+    if (!std::strcmp(env, "avx2")) cap = S21SimdLevel::kAvx2;
+    if (cap < level) level = cap;
+  }
+  return level;
+}
+
+S21SimdLevel S21GetSimdLevel() { return ActiveLevel().load(); }
+
+S21SimdLevel S21SetSimdLevel(S21SimdLevel level) {
+  // Levels above what the CPU supports are clamped, never enabled
+  S21SimdLevel detected = S21DetectSimdLevel();
+  if (level > detected) level = detected;
+  ActiveLevel().store(level);
+  return level;
+}
+
+template <typename T>
+const S21SimdKernels<T>& S21Kernels() {
+  return *KernelsFor(static_cast<const T*>(nullptr),
+                     ActiveLevel().load(std::memory_order_relaxed));
+}
+
+template const S21SimdKernels<float>& S21Kernels();
+template const S21SimdKernels<double>& S21Kernels();
+template const S21SimdKernels<long double>& S21Kernels();
+template const S21SimdKernels<std::complex<double>>& S21Kernels();
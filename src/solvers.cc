@@ -0,0 +1,615 @@
+#include "s21_solvers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "s21_kernels.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+using Complex = std::complex<double>;
+
+template <typename T>
+T Conj(T x) {
+  return x;
+}
+Complex Conj(Complex x) { return std::conj(x); }
+
+// Product of the operator with a block of vectors (one per column)
+template <typename T>
+using Operator = std::function<S21BasicMatrix<T>(const S21BasicMatrix<T>&)>;
+
+template <typename T>
+std::vector<T> ColumnDots(const S21BasicMatrix<T>& a,
+                          const S21BasicMatrix<T>& b) {
+  // a(:, c)^H * b(:, c) for every column, accumulated row by row
+  int cols = a.get_cols();
+  std::vector<T> res(cols, T(0));
+  for (int i = 0; i < a.get_rows(); ++i) {
+    const T* a_i = a.RowData(i);
+    const T* b_i = b.RowData(i);
+    for (int c = 0; c < cols; ++c) res[c] += Conj(a_i[c]) * b_i[c];
+  }
+  return res;
+}
+
+template <typename T>
+double Norm(const std::vector<T>& v) {
+  double sum = 0;
+  for (const T& x : v) sum += static_cast<double>(std::norm(x));
+  return std::sqrt(sum);
+}
+
+template <typename T>
+T Dot(const std::vector<T>& a, const std::vector<T>& b) {
+  T sum(0);
+  for (std::size_t i = 0; i < a.size(); ++i) sum += Conj(a[i]) * b[i];
+  return sum;
+}
+
+template <typename T>
+void CheckRightHandSide(int n, const S21BasicMatrix<T>& b) {
+  if (b.get_rows() != n)
+    throw CustomException(
+        "The number of rows of the right-hand side is not equal to the size "
+        "of the matrix");
+}
+
+template <typename T>
+S21IterativeResult<T> ConjugateGradient(const Operator<T>& apply, int n,
+                                        const S21BasicMatrix<T>& b,
+                                        const S21IterativeOptions& options) {
+  // Plain CG run on every column at once: the scalars alpha and beta are
+  // per column, a column that has converged keeps alpha = 0. A * P is one
+  // GEMM (or SpMM) per iteration for the whole block
+  CheckRightHandSide(n, b);
+  int cols = b.get_cols();
+  S21BasicMatrix<T> x(n, cols), r(b), p(b);
+  std::vector<T> b_norm2 = ColumnDots(b, b), rho = ColumnDots(r, r);
+  std::vector<T> alpha(cols), beta(cols);
+  std::vector<bool> done(cols);
+  S21IterativeResult<T> result{S21BasicMatrix<T>(), 0, 0, false};
+  auto residual = [&](int c) {
+    double norm = std::sqrt(static_cast<double>(std::abs(rho[c])));
+    double ref = std::sqrt(static_cast<double>(std::abs(b_norm2[c])));
+    return ref == 0 ? 0 : norm / ref;
+  };
+  for (;; ++result.iterations) {
+    bool all_done = true;
+    for (int c = 0; c < cols; ++c) {
+      done[c] = residual(c) <= options.tolerance;
+      all_done = all_done && done[c];
+    }
+    if (all_done || result.iterations == options.max_iterations) break;
+    S21BasicMatrix<T> ap = apply(p);
+    std::vector<T> pap = ColumnDots(p, ap);
+    for (int c = 0; c < cols; ++c) {
+      alpha[c] = T(0);
+      if (done[c]) continue;
+      if (!(std::real(pap[c]) > 0))
+        throw CustomException("The matrix is not positive definite");
+      alpha[c] = rho[c] / pap[c];
+    }
+    for (int i = 0; i < n; ++i) {
+      T* x_i = x.RowData(i);
+      T* r_i = r.RowData(i);
+      const T* p_i = p.RowData(i);
+      const T* ap_i = ap.RowData(i);
+      for (int c = 0; c < cols; ++c) {
+        x_i[c] += alpha[c] * p_i[c];
+        r_i[c] -= alpha[c] * ap_i[c];
+      }
+    }
+    std::vector<T> rho_next = ColumnDots(r, r);
+    for (int c = 0; c < cols; ++c)
+      beta[c] = done[c] ? T(0) : rho_next[c] / rho[c];
+    for (int i = 0; i < n; ++i) {
+      T* p_i = p.RowData(i);
+      const T* r_i = r.RowData(i);
+      for (int c = 0; c < cols; ++c) p_i[c] = r_i[c] + beta[c] * p_i[c];
+    }
+    rho = rho_next;
+  }
+  result.converged = true;
+  for (int c = 0; c < cols; ++c) {
+    result.residual = std::max(result.residual, residual(c));
+    result.converged = result.converged && done[c];
+  }
+  result.x = std::move(x);
+  return result;
+}
+
+template <typename T>
+std::vector<T> Residual(const Operator<T>& apply, const std::vector<T>& b,
+                        const std::vector<T>& x) {
+  int n = b.size();
+  S21BasicMatrix<T> x_mat(n, 1);
+  for (int i = 0; i < n; ++i) x_mat(i, 0) = x[i];
+  S21BasicMatrix<T> ax = apply(x_mat);
+  std::vector<T> r(b);
+  for (int i = 0; i < n; ++i) r[i] -= ax(i, 0);
+  return r;
+}
+
+template <typename T>
+S21IterativeResult<T> Gmres(const Operator<T>& apply, int n,
+                            const S21BasicMatrix<T>& b,
+                            const S21IterativeOptions& options) {
+  // GMRES(m) with modified Gram-Schmidt Arnoldi. The Hessenberg matrix is
+  // reduced with (complex) Givens rotations as it grows, so the residual
+  // norm of the current iterate is known at every step without solving
+  CheckRightHandSide(n, b);
+  int cols = b.get_cols(), m = std::max(1, options.restart);
+  S21IterativeResult<T> result{S21BasicMatrix<T>(n, cols), 0, 0, true};
+  std::vector<std::vector<T>> v(m + 1, std::vector<T>(n));
+  std::vector<std::vector<T>> h(m + 1, std::vector<T>(m));
+  std::vector<double> cs(m);
+  std::vector<T> sn(m), g(m + 1), y(m);
+  S21BasicMatrix<T> v_mat(n, 1);
+  for (int c = 0; c < cols; ++c) {
+    std::vector<T> b_c(n), x(n, T(0));
+    for (int i = 0; i < n; ++i) b_c[i] = b(i, c);
+    double b_norm = Norm(b_c), res_norm = b_norm;
+    int iterations = 0;
+    while (b_norm > 0 && iterations < options.max_iterations) {
+      std::vector<T> r = Residual(apply, b_c, x);
+      res_norm = Norm(r);
+      if (res_norm <= options.tolerance * b_norm) break;
+      for (int i = 0; i < n; ++i) v[0][i] = r[i] / T(res_norm);
+      std::fill(g.begin(), g.end(), T(0));
+      g[0] = res_norm;
+      int k = 0;
+      bool stop = false;
+      while (k < m && iterations < options.max_iterations && !stop) {
+        for (int i = 0; i < n; ++i) v_mat(i, 0) = v[k][i];
+        S21BasicMatrix<T> w_mat = apply(v_mat);
+        std::vector<T>& w = v[k + 1];
+        for (int i = 0; i < n; ++i) w[i] = w_mat(i, 0);
+        for (int j = 0; j <= k; ++j) {
+          h[j][k] = Dot(v[j], w);
+          for (int i = 0; i < n; ++i) w[i] -= h[j][k] * v[j][i];
+        }
+        double w_norm = Norm(w);
+        h[k + 1][k] = w_norm;
+        if (w_norm > 0)
+          for (int i = 0; i < n; ++i) w[i] /= T(w_norm);
+        for (int j = 0; j < k; ++j) {
+          T t = T(cs[j]) * h[j][k] + sn[j] * h[j + 1][k];
+          h[j + 1][k] = -Conj(sn[j]) * h[j][k] + T(cs[j]) * h[j + 1][k];
+          h[j][k] = t;
+        }
+        // Rotation that zeroes h[k + 1][k]
+        double a_abs = std::abs(h[k][k]), b_abs = std::abs(h[k + 1][k]);
+        double norm = std::hypot(a_abs, b_abs);
+        if (a_abs == 0) {
+          cs[k] = 0;
+          sn[k] = T(1);
+        } else {
+          cs[k] = a_abs / norm;
+          sn[k] = h[k][k] / T(a_abs) * Conj(h[k + 1][k]) / T(norm);
+        }
+        h[k][k] = T(cs[k]) * h[k][k] + sn[k] * h[k + 1][k];
+        h[k + 1][k] = T(0);
+        g[k + 1] = -Conj(sn[k]) * g[k];
+        g[k] = T(cs[k]) * g[k];
+        ++k;
+        ++iterations;
+        res_norm = std::abs(g[k]);
+        stop = res_norm <= options.tolerance * b_norm || w_norm == 0;
+      }
+      // x += V * y with H * y = g (upper triangular after the rotations)
+      for (int i = k - 1; i >= 0; --i) {
+        T s = g[i];
+        for (int j = i + 1; j < k; ++j) s -= h[i][j] * y[j];
+        if (h[i][i] == T(0)) throw CustomException("Matrix is singular");
+        y[i] = s / h[i][i];
+      }
+      for (int j = 0; j < k; ++j)
+        for (int i = 0; i < n; ++i) x[i] += y[j] * v[j][i];
+    }
+    if (b_norm > 0) res_norm = Norm(Residual(apply, b_c, x));
+    double relative = b_norm > 0 ? res_norm / b_norm : 0;
+    for (int i = 0; i < n; ++i) result.x(i, c) = x[i];
+    result.iterations = std::max(result.iterations, iterations);
+    result.residual = std::max(result.residual, relative);
+    result.converged = result.converged && relative <= options.tolerance;
+  }
+  return result;
+}
+
+template <typename T>
+Operator<T> DenseOperator(const S21BasicMatrix<T>& a) {
+  if (a.get_rows() != a.get_cols())
+    throw CustomException("The matrix is not square");
+  return [&a](const S21BasicMatrix<T>& x) {
+    return S21BasicMatrix<T>::Multiply(a, x);
+  };
+}
+
+template <typename T>
+Operator<T> SparseOperator(const S21BasicSparseMatrix<T>& a) {
+  if (a.get_rows() != a.get_cols())
+    throw CustomException("The matrix is not square");
+  return [&a](const S21BasicMatrix<T>& x) { return a.Multiply(x); };
+}
+
+// Rounds every element of src into dst, false when one does not fit in
+// float (or is not finite)
+bool Narrow(const S21Matrix& src, S21BasicMatrix<float>& dst) {
+  constexpr double kMax = std::numeric_limits<float>::max();
+  const double* s = src.data();
+  float* d = dst.data();
+  for (std::size_t i = 0, size = src.end() - src.begin(); i < size; ++i) {
+    if (!(std::abs(s[i]) <= kMax)) return false;
+    d[i] = static_cast<float>(s[i]);
+  }
+  return true;
+}
+
+// Largest magnitude in every column
+std::vector<double> ColumnNorms(const S21Matrix& m) {
+  std::vector<double> norms(m.get_cols(), 0);
+  for (int i = 0; i < m.get_rows(); ++i) {
+    const double* row = m[i];
+    for (int j = 0; j < m.get_cols(); ++j)
+      norms[j] = std::max(norms[j], std::abs(row[j]));
+  }
+  return norms;
+}
+
+}  // namespace
+
+template <typename T>
+S21BasicCholesky<T>::S21BasicCholesky(const S21BasicMatrix<T>& matrix)
+    : l_(matrix.rows_, matrix.rows_) {
+  // Column by column: the diagonal element first, then every row below it,
+  // which are independent. Each element is a dot product of two row
+  // prefixes of L, so all accesses are contiguous
+  if (matrix.rows_ != matrix.cols_)
+    throw CustomException("The matrix is not square");
+  int n = l_.rows_;
+  for (int j = 0; j < n; ++j) {
+    T* l_j = l_.RowPtr(j);
+    auto d = std::real(matrix.RowPtr(j)[j]);
+    for (int k = 0; k < j; ++k) d -= std::norm(l_j[k]);
+    if (!(d > 0)) throw CustomException("The matrix is not positive definite");
+    l_j[j] = std::sqrt(d);
+    S21ThreadPool::Instance().ParallelFor(
+        n - j - 1, j + 1, [&](std::size_t first, std::size_t last) {
+          for (int i = j + 1 + first; i < j + 1 + static_cast<int>(last); ++i) {
+            T* l_i = l_.RowPtr(i);
+            T s = matrix.RowPtr(i)[j];
+            for (int k = 0; k < j; ++k) s -= l_i[k] * Conj(l_j[k]);
+            l_i[j] = s / l_j[j];
+          }
+        });
+  }
+}
+
+template <typename T>
+T S21BasicCholesky<T>::Determinant() const {
+  // det(A) = det(L) * det(L^H), the diagonal of L is real
+  T res(1);
+  for (int i = 0; i < l_.rows_; ++i) res *= l_.RowPtr(i)[i] * l_.RowPtr(i)[i];
+  return res;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicCholesky<T>::Solve(
+    const S21BasicMatrix<T>& b) const {
+  // L * Y = B forwards, then L^H * X = Y backwards. The second sweep walks
+  // L by rows too: once x_i is known, its multiples are removed from the
+  // rows above
+  CheckRightHandSide(l_.rows_, b);
+  int n = l_.rows_, m = b.cols_;
+  S21BasicMatrix<T> x(b);
+  S21ThreadPool::Instance().ParallelFor(
+      m, static_cast<std::size_t>(n) * n,
+      [&](std::size_t first, std::size_t last) {
+        int j0 = first, j1 = last;
+        for (int i = 0; i < n; ++i) {
+          const T* l = l_.RowPtr(i);
+          T* x_i = x.RowPtr(i);
+          for (int k = 0; k < i; ++k) {
+            const T* x_k = x.RowPtr(k);
+            if (l[k] != T(0))
+              for (int j = j0; j < j1; ++j) x_i[j] -= l[k] * x_k[j];
+          }
+          for (int j = j0; j < j1; ++j) x_i[j] /= l[i];
+        }
+        for (int i = n - 1; i >= 0; --i) {
+          const T* l = l_.RowPtr(i);
+          T* x_i = x.RowPtr(i);
+          for (int j = j0; j < j1; ++j) x_i[j] /= l[i];
+          for (int k = 0; k < i; ++k) {
+            T* x_k = x.RowPtr(k);
+            T c = Conj(l[k]);
+            if (c != T(0))
+              for (int j = j0; j < j1; ++j) x_k[j] -= c * x_i[j];
+          }
+        }
+      });
+  return x;
+}
+
+template <typename T>
+S21BasicQR<T>::S21BasicQR(const S21BasicMatrix<T>& matrix)
+    : qr_(matrix.cols_, matrix.rows_), tau_(matrix.cols_) {
+  // Column j is reduced by the reflector H_j = I - tau * v * v^H with
+  // H_j^H * a_j = (beta, 0, ..., 0) (LAPACK's convention), then H_j^H is
+  // applied to the columns to its right, which are independent
+  if (matrix.rows_ < matrix.cols_)
+    throw CustomException("The matrix has fewer rows than columns");
+  S21Transpose(matrix.rows_, matrix.cols_, matrix.p_, matrix.cols_, qr_.p_,
+               qr_.cols_);
+  int n = qr_.rows_, m = qr_.cols_;
+  for (int j = 0; j < n; ++j) {
+    T* v = qr_.RowPtr(j) + j;
+    int len = m - j;
+    T alpha = v[0];
+    decltype(std::norm(alpha)) tail = 0;
+    for (int i = 1; i < len; ++i) tail += std::norm(v[i]);
+    if (tail == 0 && std::imag(alpha) == 0) {
+      tau_[j] = T(0);
+      continue;
+    }
+    auto beta = std::sqrt(std::norm(alpha) + tail);
+    if (std::real(alpha) >= 0) beta = -beta;
+    tau_[j] = (T(beta) - alpha) / T(beta);
+    T scale = T(1) / (alpha - T(beta));
+    for (int i = 1; i < len; ++i) v[i] *= scale;
+    v[0] = beta;
+    T tau = Conj(tau_[j]);
+    S21ThreadPool::Instance().ParallelFor(
+        n - j - 1, len, [&](std::size_t first, std::size_t last) {
+          for (int k = j + 1 + first; k < j + 1 + static_cast<int>(last); ++k) {
+            T* a = qr_.RowPtr(k) + j;
+            T w = a[0];
+            for (int i = 1; i < len; ++i) w += Conj(v[i]) * a[i];
+            w *= tau;
+            a[0] -= w;
+            for (int i = 1; i < len; ++i) a[i] -= v[i] * w;
+          }
+        });
+  }
+}
+
+template <typename T>
+void S21BasicQR<T>::ApplyQ(S21BasicMatrix<T>& b, bool adjoint) const {
+  // Every reflector touches rows j..m-1 of B: w = v^H * B is accumulated row
+  // by row, then B -= tau * v * w. Columns of B are split over the pool
+  int n = qr_.rows_, m = qr_.cols_;
+  S21ThreadPool::Instance().ParallelFor(
+      b.cols_, static_cast<std::size_t>(m) * n * 2,
+      [&](std::size_t first, std::size_t last) {
+        int c0 = first, c1 = last;
+        std::vector<T> w(c1 - c0);
+        for (int step = 0; step < n; ++step) {
+          int j = adjoint ? step : n - 1 - step;
+          T tau = adjoint ? Conj(tau_[j]) : tau_[j];
+          if (tau == T(0)) continue;
+          const T* v = qr_.RowPtr(j) + j;
+          std::copy(b.RowPtr(j) + c0, b.RowPtr(j) + c1, w.begin());
+          for (int i = 1; i < m - j; ++i) {
+            T v_i = Conj(v[i]);
+            const T* b_i = b.RowPtr(j + i);
+            for (int c = c0; c < c1; ++c) w[c - c0] += v_i * b_i[c];
+          }
+          for (T& w_c : w) w_c *= tau;
+          T* b_j = b.RowPtr(j);
+          for (int c = c0; c < c1; ++c) b_j[c] -= w[c - c0];
+          for (int i = 1; i < m - j; ++i) {
+            T v_i = v[i];
+            T* b_i = b.RowPtr(j + i);
+            for (int c = c0; c < c1; ++c) b_i[c] -= v_i * w[c - c0];
+          }
+        }
+      });
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicQR<T>::Q() const {
+  S21BasicMatrix<T> q(qr_.cols_, qr_.rows_);
+  for (int i = 0; i < qr_.rows_; ++i) q.RowPtr(i)[i] = T(1);
+  ApplyQ(q, false);
+  return q;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicQR<T>::R() const {
+  int n = qr_.rows_;
+  S21BasicMatrix<T> r(n, n);
+  for (int i = 0; i < n; ++i)
+    for (int k = i; k < n; ++k) r.RowPtr(i)[k] = qr_.RowPtr(k)[i];
+  return r;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicQR<T>::Solve(const S21BasicMatrix<T>& b) const {
+  // X = R^-1 * (Q^H * B)[0:n]. Row k of the stored matrix holds column k of
+  // R, so the back substitution removes x_k from all rows above at once
+  CheckRightHandSide(qr_.cols_, b);
+  int n = qr_.rows_, cols = b.cols_;
+  for (int i = 0; i < n; ++i)
+    if (qr_.RowPtr(i)[i] == T(0)) throw CustomException("Matrix is singular");
+  S21BasicMatrix<T> y(b);
+  ApplyQ(y, true);
+  S21BasicMatrix<T> x(n, cols);
+  std::copy(y.p_, y.p_ + x.Size(), x.p_);
+  S21ThreadPool::Instance().ParallelFor(
+      cols, static_cast<std::size_t>(n) * n / 2,
+      [&](std::size_t first, std::size_t last) {
+        int c0 = first, c1 = last;
+        for (int k = n - 1; k >= 0; --k) {
+          const T* r_k = qr_.RowPtr(k);
+          T* x_k = x.RowPtr(k);
+          for (int c = c0; c < c1; ++c) x_k[c] /= r_k[k];
+          for (int i = 0; i < k; ++i) {
+            T* x_i = x.RowPtr(i);
+            if (r_k[i] != T(0))
+              for (int c = c0; c < c1; ++c) x_i[c] -= r_k[i] * x_k[c];
+          }
+        }
+      });
+  return x;
+}
+
+S21MixedLU::S21MixedLU(const S21Matrix& matrix) : a_(matrix), a_norm_(0) {
+  if (matrix.get_rows() != matrix.get_cols())
+    throw CustomException("The matrix is not square");
+  int n = a_.get_rows();
+  for (int i = 0; i < n; ++i) {
+    const double* row = a_[i];
+    double sum = 0;
+    for (int j = 0; j < n; ++j) sum += std::abs(row[j]);
+    a_norm_ = std::max(a_norm_, sum);
+  }
+  S21BasicMatrix<float> low(n, n);
+  if (Narrow(a_, low)) {
+    lu_ = std::make_unique<S21BasicLU<float>>(low);
+    if (lu_->IsSingular()) lu_.reset();
+  }
+}
+
+const S21LU& S21MixedLU::Fallback() const {
+  std::call_once(fallback_once_, [this] {
+    fallback_ = std::make_unique<S21LU>(a_);
+    used_fallback_ = true;
+  });
+  return *fallback_;
+}
+
+S21Matrix S21MixedLU::Solve(const S21Matrix& b) const {
+  // X is corrected by float solves of A * D = B - A * X until every column
+  // satisfies ||B - A * X|| <= sqrt(n) * eps * ||A|| * ||X|| (infinity
+  // norms, eps of double), the backward error a double LU would reach. Each
+  // step costs O(n^2) per column against the O(n^3) factorization
+  int n = get_size(), cols = b.get_cols();
+  CheckRightHandSide(n, b);
+  S21BasicMatrix<float> low(n, cols);
+  if (!lu_ || !Narrow(b, low)) return Fallback().Solve(b);
+  S21Matrix x(n, cols);
+  const double eps = std::numeric_limits<double>::epsilon();
+  double limit = std::sqrt(static_cast<double>(n)) * eps * a_norm_;
+  for (int step = 0;; ++step) {
+    S21BasicMatrix<float> d = lu_->Solve(low);
+    const float* d_p = d.data();
+    double* x_p = x.data();
+    for (std::size_t i = 0, size = x.end() - x.begin(); i < size; ++i)
+      x_p[i] += d_p[i];
+    S21Matrix r = S21Matrix::Multiply(a_, x);
+    const double* b_p = b.data();
+    double* r_p = r.data();
+    for (std::size_t i = 0, size = r.end() - r.begin(); i < size; ++i)
+      r_p[i] = b_p[i] - r_p[i];
+    std::vector<double> r_norms = ColumnNorms(r), x_norms = ColumnNorms(x);
+    bool converged = true, finite = true;
+    for (int j = 0; j < cols; ++j) {
+      finite = finite && std::isfinite(x_norms[j]);
+      converged = converged && r_norms[j] <= limit * x_norms[j];
+    }
+    if (converged) return x;
+    if (!finite || step == kMaxIterations || !Narrow(r, low)) break;
+  }
+  return Fallback().Solve(b);
+}
+
+S21Matrix S21MixedLU::Inverse() const {
+  int n = get_size();
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; ++i) identity[i][i] = 1;
+  return Solve(identity);
+}
+
+template <typename T>
+S21IterativeResult<T> S21ConjugateGradient(const S21BasicMatrix<T>& a,
+                                           const S21BasicMatrix<T>& b,
+                                           const S21IterativeOptions& options) {
+  return ConjugateGradient(DenseOperator(a), a.get_rows(), b, options);
+}
+
+template <typename T>
+S21IterativeResult<T> S21ConjugateGradient(const S21BasicSparseMatrix<T>& a,
+                                           const S21BasicMatrix<T>& b,
+                                           const S21IterativeOptions& options) {
+  return ConjugateGradient(SparseOperator(a), a.get_rows(), b, options);
+}
+
+template <typename T>
+S21IterativeResult<T> S21Gmres(const S21BasicMatrix<T>& a,
+                               const S21BasicMatrix<T>& b,
+                               const S21IterativeOptions& options) {
+  return Gmres(DenseOperator(a), a.get_rows(), b, options);
+}
+
+template <typename T>
+S21IterativeResult<T> S21Gmres(const S21BasicSparseMatrix<T>& a,
+                               const S21BasicMatrix<T>& b,
+                               const S21IterativeOptions& options) {
+  return Gmres(SparseOperator(a), a.get_rows(), b, options);
+}
+
+template class S21BasicCholesky<float>;
+template class S21BasicCholesky<double>;
+template class S21BasicCholesky<long double>;
+template class S21BasicCholesky<Complex>;
+template class S21BasicQR<float>;
+template class S21BasicQR<double>;
+template class S21BasicQR<long double>;
+template class S21BasicQR<Complex>;
+
+template S21IterativeResult<float> S21ConjugateGradient(
+    const S21BasicMatrix<float>&, const S21BasicMatrix<float>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<float> S21ConjugateGradient(
+    const S21BasicSparseMatrix<float>&, const S21BasicMatrix<float>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<float> S21Gmres(
+    const S21BasicMatrix<float>&, const S21BasicMatrix<float>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<float> S21Gmres(
+    const S21BasicSparseMatrix<float>&, const S21BasicMatrix<float>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<double> S21ConjugateGradient(
+    const S21BasicMatrix<double>&, const S21BasicMatrix<double>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<double> S21ConjugateGradient(
+    const S21BasicSparseMatrix<double>&, const S21BasicMatrix<double>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<double> S21Gmres(
+    const S21BasicMatrix<double>&, const S21BasicMatrix<double>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<double> S21Gmres(
+    const S21BasicSparseMatrix<double>&, const S21BasicMatrix<double>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<long double> S21ConjugateGradient(
+    const S21BasicMatrix<long double>&, const S21BasicMatrix<long double>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<long double> S21ConjugateGradient(
+    const S21BasicSparseMatrix<long double>&,
+    const S21BasicMatrix<long double>&, const S21IterativeOptions&);
+template S21IterativeResult<long double> S21Gmres(
+    const S21BasicMatrix<long double>&, const S21BasicMatrix<long double>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<long double> S21Gmres(
+    const S21BasicSparseMatrix<long double>&,
+    const S21BasicMatrix<long double>&, const S21IterativeOptions&);
+template S21IterativeResult<Complex> S21ConjugateGradient(
+    const S21BasicMatrix<Complex>&, const S21BasicMatrix<Complex>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<Complex> S21ConjugateGradient(
+    const S21BasicSparseMatrix<Complex>&, const S21BasicMatrix<Complex>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<Complex> S21Gmres(
+    const S21BasicMatrix<Complex>&, const S21BasicMatrix<Complex>&,
+    const S21IterativeOptions&);
+template S21IterativeResult<Complex> S21Gmres(
+    const S21BasicSparseMatrix<Complex>&, const S21BasicMatrix<Complex>&,
+    const S21IterativeOptions&);
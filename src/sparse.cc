@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <utility>
+
+#include "s21_sparse_matrix.h"
+#include "s21_thread_pool.h"
+
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(int rows, int cols,
+                                              S21SparseFormat format)
+    : rows_(rows), cols_(cols), format_(format) {
+  if (rows < 1 || cols < 1)
+    throw CustomException("Rows and cols must be not less that 1");
+  ptr_.assign(MajorCount() + 1, 0);
+}
+
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(
+    int rows, int cols, const std::vector<S21Triplet<T>>& triplets,
+    S21SparseFormat format)
+    : S21BasicSparseMatrix(rows, cols, format) {
+  for (const S21Triplet<T>& t : triplets)
+    if (t.row < 0 || t.row >= rows_ || t.col < 0 || t.col >= cols_)
+      throw std::out_of_range("Incorrect input, index is out of range");
+  std::vector<S21Triplet<T>> entries(triplets);
+  Compress(entries);
+}
+
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(const S21BasicMatrix<T>& dense,
+                                              S21SparseFormat format,
+                                              double eps)
+    : S21BasicSparseMatrix(dense.get_rows(), dense.get_cols()) {
+  // Rows of the dense matrix are scanned in order, which directly gives
+  // CSR; CSC is obtained from it by a counting sort
+  for (int i = 0; i < rows_; ++i) {
+    const T* row = dense[i];
+    for (int j = 0; j < cols_; ++j)
+      if (std::abs(row[j]) > eps) {
+        idx_.push_back(j);
+        values_.push_back(row[j]);
+      }
+    ptr_[i + 1] = values_.size();
+  }
+  if (format != format_) *this = ToFormat(format);
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::Compress(std::vector<S21Triplet<T>>& entries) {
+  bool csr = format_ == S21SparseFormat::kCsr;
+  auto major = [csr](const S21Triplet<T>& e) { return csr ? e.row : e.col; };
+  auto minor = [csr](const S21Triplet<T>& e) { return csr ? e.col : e.row; };
+  std::sort(entries.begin(), entries.end(),
+            [&](const S21Triplet<T>& a, const S21Triplet<T>& b) {
+              return major(a) != major(b) ? major(a) < major(b)
+                                          : minor(a) < minor(b);
+            });
+  ptr_.assign(MajorCount() + 1, 0);
+  idx_.clear();
+  values_.clear();
+  for (std::size_t i = 0, j; i < entries.size(); i = j) {
+    T sum = T(0);
+    for (j = i; j < entries.size() && major(entries[j]) == major(entries[i]) &&
+                minor(entries[j]) == minor(entries[i]);
+         ++j)
+      sum += entries[j].value;
+    if (sum != T(0)) {
+      idx_.push_back(minor(entries[i]));
+      values_.push_back(sum);
+      ++ptr_[major(entries[i]) + 1];
+    }
+  }
+  for (int m = 0; m < MajorCount(); ++m) ptr_[m + 1] += ptr_[m];
+}
+
+template <typename T>
+T S21BasicSparseMatrix<T>::operator()(int row, int col) const {
+  // Binary search among the sorted minor indices of one row (or column)
+  if (row >= rows_ || col >= cols_ || col < 0 || row < 0)
+    throw std::out_of_range("Incorrect input, index is out of range");
+  bool csr = format_ == S21SparseFormat::kCsr;
+  int major = csr ? row : col, minor = csr ? col : row;
+  auto begin = idx_.begin() + ptr_[major], end = idx_.begin() + ptr_[major + 1];
+  auto it = std::lower_bound(begin, end, minor);
+  return it != end && *it == minor ? values_[it - idx_.begin()] : T(0);
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::ToFormat(
+    S21SparseFormat format) const {
+  // Counting sort by the minor index: entries are visited in major order,
+  // so every new row (or column) comes out sorted
+  if (format == format_) return *this;
+  S21BasicSparseMatrix res(rows_, cols_, format);
+  for (int minor : idx_) ++res.ptr_[minor + 1];
+  for (int m = 0; m < res.MajorCount(); ++m) res.ptr_[m + 1] += res.ptr_[m];
+  res.idx_.resize(idx_.size());
+  res.values_.resize(values_.size());
+  std::vector<std::size_t> next(res.ptr_.begin(), res.ptr_.end() - 1);
+  for (int m = 0; m < MajorCount(); ++m)
+    for (std::size_t k = ptr_[m]; k < ptr_[m + 1]; ++k) {
+      std::size_t pos = next[idx_[k]]++;
+      res.idx_[pos] = m;
+      res.values_[pos] = values_[k];
+    }
+  return res;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::Transpose() const {
+  S21BasicSparseMatrix res(*this);
+  res.TransposeInPlace();
+  return res;
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::TransposeInPlace() {
+  // The arrays of a CSR matrix are exactly the CSC arrays of its transpose
+  std::swap(rows_, cols_);
+  format_ = format_ == S21SparseFormat::kCsr ? S21SparseFormat::kCsc
+                                             : S21SparseFormat::kCsr;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicSparseMatrix<T>::ToDense() const {
+  bool csr = format_ == S21SparseFormat::kCsr;
+  S21BasicMatrix<T> res(rows_, cols_);
+  for (int m = 0; m < MajorCount(); ++m)
+    for (std::size_t k = ptr_[m]; k < ptr_[m + 1]; ++k) {
+      if (csr)
+        res[m][idx_[k]] = values_[k];
+      else
+        res[idx_[k]][m] = values_[k];
+    }
+  return res;
+}
+
+template <typename T>
+std::vector<T> S21BasicSparseMatrix<T>::Multiply(
+    const std::vector<T>& x) const {
+  // CSR: every y[i] is a dot product of row i with x, rows are independent.
+  // CSC: every column j adds x[j] times itself to y
+  if (static_cast<int>(x.size()) != cols_)
+    throw CustomException(
+        "The size of the vector is not equal to the number of columns of the "
+        "matrix");
+  std::vector<T> y(rows_, T(0));
+  if (format_ == S21SparseFormat::kCsr) {
+    S21ThreadPool::Instance().ParallelFor(
+        rows_, values_.size() / rows_ + 1,
+        [&](std::size_t first, std::size_t last) {
+          for (std::size_t i = first; i < last; ++i) {
+            T sum = T(0);
+            for (std::size_t k = ptr_[i]; k < ptr_[i + 1]; ++k)
+              sum += values_[k] * x[idx_[k]];
+            y[i] = sum;
+          }
+        });
+  } else {
+    for (int j = 0; j < cols_; ++j)
+      for (std::size_t k = ptr_[j]; k < ptr_[j + 1]; ++k)
+        y[idx_[k]] += values_[k] * x[j];
+  }
+  return y;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicSparseMatrix<T>::Multiply(
+    const S21BasicMatrix<T>& b) const {
+  // Row i of the result is the sum of the rows of b picked by the entries
+  // of row i, each scaled by its value, so b is only read along its rows
+  if (b.get_rows() != cols_)
+    throw CustomException(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  int n = b.get_cols();
+  S21BasicMatrix<T> res(rows_, n);
+  auto add_row = [&](int i, int k, T value) {
+    const T* b_row = b.RowData(k);
+    T* c_row = res.RowData(i);
+    for (int j = 0; j < n; ++j) c_row[j] += value * b_row[j];
+  };
+  if (format_ == S21SparseFormat::kCsr) {
+    S21ThreadPool::Instance().ParallelFor(
+        rows_, (values_.size() / rows_ + 1) * n,
+        [&](std::size_t first, std::size_t last) {
+          for (std::size_t i = first; i < last; ++i)
+            for (std::size_t k = ptr_[i]; k < ptr_[i + 1]; ++k)
+              add_row(i, idx_[k], values_[k]);
+        });
+  } else {
+    for (int j = 0; j < cols_; ++j)
+      for (std::size_t k = ptr_[j]; k < ptr_[j + 1]; ++k)
+        add_row(idx_[k], j, values_[k]);
+  }
+  return res;
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::Add(
+    const S21BasicSparseMatrix& other) const {
+  // Sorted rows (or columns) are merged in two parallel passes: the first
+  // one counts the entries of every merged row, the second one writes them
+  // at offsets known from the counts. Sums that cancel out are dropped
+  if (rows_ != other.rows_ || cols_ != other.cols_)
+    throw CustomException("Different matrix dimensions");
+  if (other.format_ != format_) return Add(other.ToFormat(format_));
+  S21BasicSparseMatrix res(rows_, cols_, format_);
+  auto merge = [&](int m, int* idx, T* values) {
+    std::size_t a = ptr_[m], b = other.ptr_[m], count = 0;
+    while (a < ptr_[m + 1] || b < other.ptr_[m + 1]) {
+      int minor;
+      T sum;
+      if (b == other.ptr_[m + 1] ||
+          (a < ptr_[m + 1] && idx_[a] < other.idx_[b])) {
+        minor = idx_[a];
+        sum = values_[a++];
+      } else if (a == ptr_[m + 1] || other.idx_[b] < idx_[a]) {
+        minor = other.idx_[b];
+        sum = other.values_[b++];
+      } else {
+        minor = idx_[a];
+        sum = values_[a++] + other.values_[b++];
+      }
+      if (sum == T(0)) continue;
+      if (idx) {
+        idx[count] = minor;
+        values[count] = sum;
+      }
+      ++count;
+    }
+    return count;
+  };
+  int majors = MajorCount();
+  std::size_t work = (values_.size() + other.values_.size()) / majors + 1;
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  pool.ParallelFor(majors, work, [&](std::size_t first, std::size_t last) {
+    for (std::size_t m = first; m < last; ++m)
+      res.ptr_[m + 1] = merge(m, nullptr, nullptr);
+  });
+  for (int m = 0; m < majors; ++m) res.ptr_[m + 1] += res.ptr_[m];
+  res.idx_.resize(res.ptr_[majors]);
+  res.values_.resize(res.ptr_[majors]);
+  pool.ParallelFor(majors, work, [&](std::size_t first, std::size_t last) {
+    for (std::size_t m = first; m < last; ++m)
+      merge(m, res.idx_.data() + res.ptr_[m], res.values_.data() + res.ptr_[m]);
+  });
+  return res;
+}
+
+template class S21BasicSparseMatrix<float>;
+template class S21BasicSparseMatrix<double>;
+template class S21BasicSparseMatrix<long double>;
+template class S21BasicSparseMatrix<std::complex<double>>;
@@ -0,0 +1,223 @@
+#include "s21_kernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <memory>
+#include <memory_resource>
+
+#include "s21_memory.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+using Complex = std::complex<double>;
+
+// Tuned on AVX2 with the blocked S21Gemm: below this size one recursion
+// level costs more in additions than it saves in multiplications
+constexpr int kDefaultCrossover = 512;
+
+std::atomic<int> crossover(kDefaultCrossover);
+
+// Strided operand: element (i, j) is p[i * rs + j * cs]
+template <typename T>
+struct Operand {
+  const T* p;
+  std::ptrdiff_t rs, cs;
+
+  Operand Block(int row, int col) const {
+    return {p + row * rs + col * cs, rs, cs};
+  }
+};
+
+template <typename T>
+void Combine(int rows, int cols, Operand<T> x, Operand<T> y, bool subtract,
+             T* out, std::ptrdiff_t ldo) {
+  // out = x + y or out = x - y, row by row on the thread pool; out may be
+  // x or y itself
+  S21ThreadPool::Instance().ParallelFor(
+      rows, cols, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+          const T* x_i = x.p + i * x.rs;
+          const T* y_i = y.p + i * y.rs;
+          T* o = out + i * ldo;
+          if (x.cs == 1 && y.cs == 1) {
+            if (subtract)
+              for (int j = 0; j < cols; ++j) o[j] = x_i[j] - y_i[j];
+            else
+              for (int j = 0; j < cols; ++j) o[j] = x_i[j] + y_i[j];
+          } else {
+            for (int j = 0; j < cols; ++j) {
+              T v = y_i[j * y.cs];
+              o[j] = subtract ? x_i[j * x.cs] - v : x_i[j * x.cs] + v;
+            }
+          }
+        }
+      });
+}
+
+template <typename T>
+Operand<T> Dense(const T* p, std::ptrdiff_t ld) {
+  return {p, ld, 1};
+}
+
+// Elements of workspace needed by Winograd() for an m x n x k product
+std::size_t WorkspaceSize(int m, int n, int k, int cutoff) {
+  std::size_t size = 0;
+  while (std::min({m, n, k}) > cutoff) {
+    m /= 2;
+    n /= 2;
+    k /= 2;
+    size += static_cast<std::size_t>(m) * k + static_cast<std::size_t>(k) * n +
+            static_cast<std::size_t>(m) * n;
+  }
+  return size;
+}
+
+template <typename T>
+class Workspace {
+  // Scratch elements from the current memory resource of the thread, see
+  // S21GetResource(), held for the lifetime of the object
+ public:
+  explicit Workspace(std::size_t size)
+      : resource_(S21GetResource()),
+        size_(size),
+        p_(static_cast<T*>(
+            resource_->allocate(size * sizeof(T), kAlignment))) {
+    std::uninitialized_default_construct_n(p_, size_);
+  }
+  Workspace(const Workspace&) = delete;
+  Workspace& operator=(const Workspace&) = delete;
+  ~Workspace() { resource_->deallocate(p_, size_ * sizeof(T), kAlignment); }
+
+  T* get() const { return p_; }
+
+ private:
+  static constexpr std::size_t kAlignment = 64;
+
+  std::pmr::memory_resource* resource_;
+  std::size_t size_;
+  T* p_;
+};
+
+template <typename T>
+void Winograd(int m, int n, int k, Operand<T> a, Operand<T> b, T* c,
+              std::ptrdiff_t ldc, int cutoff, T* work) {
+  // C = A * B with the Strassen-Winograd variant (7 products, 15
+  // additions). The even part is split into quadrants; an odd last row,
+  // column or inner index is peeled off and handled by S21Gemm afterwards.
+  // The 22-step schedule keeps all intermediate sums in three quadrant-sized
+  // buffers (X, Y, Z) and the quadrants of C; the recursive products share
+  // the workspace that follows them
+  if (std::min({m, n, k}) <= cutoff) {
+    S21Gemm(m, n, k, a.p, a.rs, a.cs, b.p, b.rs, b.cs, c, ldc, false);
+    return;
+  }
+  int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+  T* x = work;
+  T* y = x + static_cast<std::size_t>(m2) * k2;
+  T* z = y + static_cast<std::size_t>(k2) * n2;
+  T* next = z + static_cast<std::size_t>(m2) * n2;
+  Operand<T> a11 = a, a12 = a.Block(0, k2), a21 = a.Block(m2, 0),
+             a22 = a.Block(m2, k2);
+  Operand<T> b11 = b, b12 = b.Block(0, n2), b21 = b.Block(k2, 0),
+             b22 = b.Block(k2, n2);
+  T* c11 = c;
+  T* c12 = c + n2;
+  T* c21 = c + m2 * ldc;
+  T* c22 = c21 + n2;
+  Operand<T> xo = Dense(x, k2), yo = Dense(y, n2);
+  auto product = [&](Operand<T> p, Operand<T> q, T* out, std::ptrdiff_t ld) {
+    Winograd(m2, n2, k2, p, q, out, ld, cutoff, next);
+  };
+  auto sum = [&](int rows, int cols, Operand<T> p, Operand<T> q, T* out,
+                 std::ptrdiff_t ld) {
+    Combine(rows, cols, p, q, false, out, ld);
+  };
+  auto diff = [&](int rows, int cols, Operand<T> p, Operand<T> q, T* out,
+                  std::ptrdiff_t ld) {
+    Combine(rows, cols, p, q, true, out, ld);
+  };
+  Operand<T> c11o = Dense(c11, ldc), c12o = Dense(c12, ldc),
+             c21o = Dense(c21, ldc), c22o = Dense(c22, ldc),
+             zo = Dense(z, n2);
+
+  diff(m2, k2, a11, a21, x, k2);       // X = S3 = A11 - A21
+  diff(k2, n2, b22, b12, y, n2);       // Y = T3 = B22 - B12
+  product(xo, yo, c21, ldc);           // C21 = P7 = S3 * T3
+  sum(m2, k2, a21, a22, x, k2);        // X = S1 = A21 + A22
+  diff(k2, n2, b12, b11, y, n2);       // Y = T1 = B12 - B11
+  product(xo, yo, c22, ldc);           // C22 = P5 = S1 * T1
+  diff(m2, k2, xo, a11, x, k2);        // X = S2 = S1 - A11
+  diff(k2, n2, b22, yo, y, n2);        // Y = T2 = B22 - T1
+  product(xo, yo, c12, ldc);           // C12 = P6 = S2 * T2
+  diff(m2, k2, a12, xo, x, k2);        // X = S4 = A12 - S2
+  product(xo, b22, c11, ldc);          // C11 = P3 = S4 * B22
+  product(a11, b11, z, n2);            // Z = P1 = A11 * B11
+  sum(m2, n2, zo, c12o, c12, ldc);     // C12 = U2 = P1 + P6
+  sum(m2, n2, c12o, c21o, c21, ldc);   // C21 = U3 = U2 + P7
+  sum(m2, n2, c12o, c22o, c12, ldc);   // C12 = U4 = U2 + P5
+  sum(m2, n2, c21o, c22o, c22, ldc);   // C22 = U7 = U3 + P5
+  sum(m2, n2, c12o, c11o, c12, ldc);   // C12 = U5 = U4 + P3
+  diff(k2, n2, yo, b21, y, n2);        // Y = T4 = T2 - B21
+  product(a22, yo, c11, ldc);          // C11 = P4 = A22 * T4
+  diff(m2, n2, c21o, c11o, c21, ldc);  // C21 = U6 = U3 - P4
+  product(a12, b21, c11, ldc);         // C11 = P2 = A12 * B21
+  sum(m2, n2, c11o, zo, c11, ldc);     // C11 = U1 = P2 + P1
+
+  // Peeling: the odd inner index updates the even block, the odd row and
+  // column are plain products
+  int me = 2 * m2, ne = 2 * n2, ke = 2 * k2;
+  if (ke < k) {
+    Operand<T> a_col = a.Block(0, ke), b_row = b.Block(ke, 0);
+    S21Gemm(me, ne, k - ke, a_col.p, a.rs, a.cs, b_row.p, b.rs, b.cs, c, ldc,
+            true);
+  }
+  if (ne < n) {
+    Operand<T> b_col = b.Block(0, ne);
+    S21Gemm(m, n - ne, k, a.p, a.rs, a.cs, b_col.p, b.rs, b.cs, c + ne, ldc,
+            false);
+  }
+  if (me < m) {
+    Operand<T> a_row = a.Block(me, 0);
+    S21Gemm(m - me, ne, k, a_row.p, a.rs, a.cs, b.p, b.rs, b.cs, c + me * ldc,
+            ldc, false);
+  }
+}
+
+}  // namespace
+
+int S21GetStrassenCrossover() { return crossover.load(); }
+
+void S21SetStrassenCrossover(int size) {
+  crossover = size > 0 ? size : kDefaultCrossover;
+}
+
+template <typename T>
+void S21Strassen(int m, int n, int k, const T* a, std::ptrdiff_t rsa,
+                 std::ptrdiff_t csa, const T* b, std::ptrdiff_t rsb,
+                 std::ptrdiff_t csb, T* c, std::ptrdiff_t ldc) {
+  // One workspace serves all recursion levels: each level takes its three
+  // buffers from the front and lends the rest to its products, which run one
+  // after another. That bounds the extra memory to about a third of
+  // m * k + k * n + m * n elements. It comes from the current resource, so
+  // a pool or an arena set up by the caller serves it too, and it is
+  // released after the call
+  int cutoff = S21GetStrassenCrossover();
+  Workspace<T> work(WorkspaceSize(m, n, k, cutoff));
+  Winograd(m, n, k, Operand<T>{a, rsa, csa}, Operand<T>{b, rsb, csb}, c, ldc,
+           cutoff, work.get());
+}
+
+template void S21Strassen(int, int, int, const float*, std::ptrdiff_t,
+                          std::ptrdiff_t, const float*, std::ptrdiff_t,
+                          std::ptrdiff_t, float*, std::ptrdiff_t);
+template void S21Strassen(int, int, int, const double*, std::ptrdiff_t,
+                          std::ptrdiff_t, const double*, std::ptrdiff_t,
+                          std::ptrdiff_t, double*, std::ptrdiff_t);
+template void S21Strassen(int, int, int, const long double*, std::ptrdiff_t,
+                          std::ptrdiff_t, const long double*, std::ptrdiff_t,
+                          std::ptrdiff_t, long double*, std::ptrdiff_t);
+template void S21Strassen(int, int, int, const Complex*, std::ptrdiff_t,
+                          std::ptrdiff_t, const Complex*, std::ptrdiff_t,
+                          std::ptrdiff_t, Complex*, std::ptrdiff_t);
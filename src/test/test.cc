@@ -1,6 +1,24 @@
 #include <gtest/gtest.h>
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <type_traits>
+
+#include "../s21_fixed_matrix.h"
+#include "../s21_instrument.h"
+#include "../s21_kernels.h"
+#include "../s21_matrix_batch.h"
+#include "../s21_matrix_file.h"
+#include "../s21_matrix_graph.h"
 #include "../s21_matrix_oop.h"
+#include "../s21_memory.h"
+#include "../s21_solvers.h"
+#include "../s21_sparse_matrix.h"
+#include "../s21_thread_pool.h"
 
 class S21MatrixTest : public ::testing::Test {
  protected:
@@ -99,6 +117,19 @@ TEST_F(S21MatrixTest, SetColsTest) {
   ASSERT_ANY_THROW(m1.set_cols(0));
 }
 
+TEST(Other, ResizeRectangularTest) {
+  S21Matrix m1(2, 5);
+  for (int i = 0; i < m1.get_rows(); ++i)
+    for (int j = 0; j < m1.get_cols(); ++j) m1(i, j) = i * 10 + j;
+  m1.set_cols(3);
+  m1.set_rows(4);
+  EXPECT_EQ(4, m1.get_rows());
+  EXPECT_EQ(3, m1.get_cols());
+  for (int i = 0; i < m1.get_rows(); ++i)
+    for (int j = 0; j < m1.get_cols(); ++j)
+      EXPECT_DOUBLE_EQ(i < 2 ? i * 10 + j : 0, m1(i, j));
+}
+
 TEST_F(S21MatrixTest, EqTest) {
   EXPECT_TRUE(m1.EqMatrix(m2));
   m2(0, 1) = 1;
@@ -182,6 +213,39 @@ TEST_F(S21MatrixTest, MulNumberOperatorTest) {
       EXPECT_DOUBLE_EQ(2 * ((i + 1) * j + 1), m4(i, j));
 }
 
+TEST_F(S21MatrixTest, ExpressionChainTest) {
+  S21Matrix m3 = m1 + m2 - m1 * 2.0 + 3 * m2;
+  for (int i = 0; i < m3.get_rows(); ++i)
+    for (int j = 0; j < m3.get_cols(); ++j)
+      EXPECT_DOUBLE_EQ(3 * ((i + 1) * j + 1), m3(i, j));
+
+  // Temporaries are kept inside the expression, so this one may outlive
+  // the full statement that created it
+  auto expr = (m1 * m2) + S21Matrix(m1);
+  S21Matrix m4 = expr;
+  EXPECT_TRUE(m4 == m1 * m2 + m1);
+
+  m1 = m1 + m2 + m1;
+  m2 += m2 - m1 * 0.5;
+  for (int i = 0; i < m1.get_rows(); ++i)
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      EXPECT_DOUBLE_EQ(3 * ((i + 1) * j + 1), m1(i, j));
+      EXPECT_DOUBLE_EQ(0.5 * ((i + 1) * j + 1), m2(i, j));
+    }
+  m2 -= m2 * 2;
+  EXPECT_TRUE(m2 == -1 * (m1 * (1. / 6)));
+
+  S21Matrix m5 = (m1 + m1) * (m2 - m2);
+  EXPECT_TRUE(m5 == S21Matrix(3, 3));
+
+  S21Matrix m6(2, 2);
+  ASSERT_ANY_THROW(m1 + m6 * 2);
+  ASSERT_ANY_THROW(m6 += m1 + m1);
+  m6 = m1 * 2 + m1;
+  EXPECT_EQ(3, m6.get_rows());
+  EXPECT_EQ(3, m6.get_cols());
+}
+
 TEST_F(S21MatrixTest, MulMatrixTest) {
   m1.MulMatrix(m2);
   EXPECT_EQ(3, m1.get_cols());
@@ -283,6 +347,1230 @@ TEST_F(S21MatrixTest, InverseMatrixTest) {
   ASSERT_ANY_THROW(m2.InverseMatrix());
 }
 
+TEST(Other, LargeDeterminantTest) {
+  // I + ones(n) has determinant n + 1
+  S21Matrix m1(12, 12);
+  for (int i = 0; i < m1.get_rows(); ++i)
+    for (int j = 0; j < m1.get_cols(); ++j) m1(i, j) = i == j ? 2 : 1;
+  EXPECT_NEAR(13, m1.Determinant(), 1e-9);
+
+  S21Matrix m2 = m1.InverseMatrix();
+  m2.MulMatrix(m1);
+  for (int i = 0; i < m2.get_rows(); ++i)
+    for (int j = 0; j < m2.get_cols(); ++j)
+      EXPECT_NEAR(i == j ? 1 : 0, m2(i, j), 1e-9);
+}
+
+TEST(Other, LargeCalcComplementsTest) {
+  S21Matrix m1(4, 4);
+  for (int i = 0; i < m1.get_rows(); ++i)
+    for (int j = 0; j < m1.get_cols(); ++j) m1(i, j) = (i * 7 + j * 3) % 5 + i;
+  // A * C^T = det(A) * I
+  S21Matrix m2 = m1 * m1.CalcComplements().Transpose();
+  double det = m1.Determinant();
+  for (int i = 0; i < m2.get_rows(); ++i)
+    for (int j = 0; j < m2.get_cols(); ++j)
+      EXPECT_NEAR(i == j ? det : 0, m2(i, j), 1e-9);
+
+  // Singular matrix: the first and the last rows are equal
+  for (int j = 0; j < m1.get_cols(); ++j) m1(3, j) = m1(0, j);
+  m2 = m1 * m1.CalcComplements().Transpose();
+  for (int i = 0; i < m2.get_rows(); ++i)
+    for (int j = 0; j < m2.get_cols(); ++j) EXPECT_NEAR(0, m2(i, j), 1e-9);
+}
+
+TEST(Other, LargeMulMatrixTest) {
+  // Big enough to go through the packed kernel, with ragged edge blocks
+  S21Matrix m1(131, 517), m2(517, 77);
+  for (int i = 0; i < m1.get_rows(); ++i)
+    for (int j = 0; j < m1.get_cols(); ++j) m1(i, j) = (i * 3 + j) % 7 - 3;
+  for (int i = 0; i < m2.get_rows(); ++i)
+    for (int j = 0; j < m2.get_cols(); ++j) m2(i, j) = (i + j * 5) % 11 - 5;
+  S21Matrix m3 = m1 * m2;
+  EXPECT_EQ(131, m3.get_rows());
+  EXPECT_EQ(77, m3.get_cols());
+  for (int i = 0; i < m3.get_rows(); ++i)
+    for (int j = 0; j < m3.get_cols(); ++j) {
+      double sum = 0;
+      for (int k = 0; k < m1.get_cols(); ++k) sum += m1(i, k) * m2(k, j);
+      EXPECT_DOUBLE_EQ(sum, m3(i, j));
+    }
+  m1.MulMatrix(m2);
+  EXPECT_TRUE(m1 == m3);
+}
+
+TEST(Other, TransposeInPlaceTest) {
+  // Sizes around the tile size, with ragged edges, several threads and the
+  // rectangular cycle-following path
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  std::size_t threshold = pool.get_serial_threshold();
+  pool.set_serial_threshold(64);
+  const int sizes[][2] = {{1, 1}, {1, 9}, {9, 1}, {130, 130}, {67, 201},
+                          {200, 3}};
+  for (auto& size : sizes) {
+    S21Matrix m1(size[0], size[1]);
+    for (int i = 0; i < m1.get_rows(); ++i)
+      for (int j = 0; j < m1.get_cols(); ++j) m1(i, j) = i * 1000 + j;
+    S21Matrix m2 = m1.Transpose();
+    S21Matrix m3(m1);
+    m3.TransposeInPlace();
+    EXPECT_EQ(size[1], m3.get_rows());
+    EXPECT_EQ(size[0], m3.get_cols());
+    for (int i = 0; i < m3.get_rows(); ++i)
+      for (int j = 0; j < m3.get_cols(); ++j) {
+        EXPECT_EQ(j * 1000 + i, m2(i, j));
+        EXPECT_EQ(j * 1000 + i, m3(i, j));
+      }
+    m3.TransposeInPlace();
+    EXPECT_TRUE(m1 == m3);
+  }
+  pool.set_serial_threshold(threshold);
+}
+
+TEST(Other, MatrixViewTest) {
+  S21Matrix m1(6, 8);
+  for (int i = 0; i < m1.get_rows(); ++i)
+    for (int j = 0; j < m1.get_cols(); ++j) m1(i, j) = i * 10 + j;
+  S21MatrixView block = m1.Block(1, 2, 3, 4);
+  EXPECT_EQ(3, block.get_rows());
+  EXPECT_EQ(4, block.get_cols());
+  EXPECT_EQ(34, block(2, 2));
+  EXPECT_EQ(35, m1.Row(3)(0, 5));
+  EXPECT_EQ(57, m1.Col(7)(5, 0));
+  EXPECT_EQ(44, m1.Diagonal()(4, 0));
+  EXPECT_EQ(6, m1.Diagonal().get_rows());
+  S21MatrixView strided = m1.Strided(1, 0, 3, 3, 2, 3);
+  EXPECT_EQ(56, strided(2, 2));
+  EXPECT_EQ(33, strided(1, 1));
+  EXPECT_EQ(35, block.Block(1, 1, 2, 3)(1, 2));
+  EXPECT_THROW(m1.Block(4, 0, 3, 1), std::out_of_range);
+  EXPECT_THROW(m1.Strided(0, 0, 4, 1, 2, 1), std::out_of_range);
+  EXPECT_THROW(block(3, 0), std::out_of_range);
+
+  // Views are expression operands and write through to the parent
+  S21Matrix m2 = m1.Row(0) + 2.0 * m1.Row(1);
+  EXPECT_EQ(1, m2.get_rows());
+  EXPECT_EQ(29, m2(0, 3));
+  m1.Row(5) = m1.Row(4) - m1.Row(5);
+  EXPECT_EQ(-10, m1(5, 7));
+  m1.Col(0) *= 2;
+  EXPECT_EQ(60, m1(3, 0));
+  m1.Block(0, 0, 2, 2) += m1.Block(2, 2, 2, 2);
+  EXPECT_EQ(0 + 22, m1(0, 0));
+  EXPECT_EQ(11 + 33, m1(1, 1));
+  EXPECT_THROW(m1.Row(0) = m1.Col(0), CustomException);
+
+  // A const matrix only hands out read-only views; writable views convert
+  // to them
+  const S21Matrix& cm1 = m1;
+  static_assert(std::is_same<decltype(cm1.Block(0, 0, 2, 2)(1, 1)),
+                             const double&>::value,
+                "Views of a const matrix are read-only");
+  S21BasicMatrixView<const double> row1 = m1.Row(1);
+  EXPECT_EQ(m1(1, 3), row1(0, 3));
+  EXPECT_EQ(m1(3, 2), cm1.Strided(1, 0, 3, 3, 2, 1)(1, 2));
+  EXPECT_TRUE(S21Matrix(row1 + cm1.Row(1)) == S21Matrix(m1.Row(1) * 2.0));
+  EXPECT_TRUE(S21Matrix::Multiply(cm1.Col(0), row1) ==
+              S21Matrix(m1.Col(0)) * S21Matrix(m1.Row(1)));
+  m1.Row(2) = cm1.Row(1);
+  EXPECT_EQ(m1(1, 4), m1(2, 4));
+
+  // Products read views through their strides, e.g. a transposed block
+  S21Matrix m3(40, 50);
+  for (int i = 0; i < m3.get_rows(); ++i)
+    for (int j = 0; j < m3.get_cols(); ++j) m3(i, j) = (i * 7 + j) % 9 - 4;
+  S21Matrix t = m3.Transpose();
+  S21MatrixView a = m3.Block(3, 1, 35, 45), b = t.Block(2, 4, 45, 30);
+  S21Matrix m4 = a * b, m5 = S21Matrix(a) * S21Matrix(b);
+  EXPECT_EQ(35, m4.get_rows());
+  EXPECT_EQ(30, m4.get_cols());
+  EXPECT_TRUE(m4 == m5);
+  S21MatrixView ts(&m3(3, 1), 45, 35, 1, m3.get_cols());
+  EXPECT_TRUE(S21Matrix(ts * a) == S21Matrix(a).Transpose() * S21Matrix(a));
+  S21Matrix m6 = m3.Strided(0, 0, 20, 25, 2, 2);
+  m6.MulMatrix(m3.Col(0).Block(0, 0, 25, 1));
+  EXPECT_EQ(20, m6.get_rows());
+  EXPECT_EQ(1, m6.get_cols());
+  EXPECT_TRUE(m6 == S21Matrix(m3.Strided(0, 0, 20, 25, 2, 2) *
+                              S21Matrix(m3.Block(0, 0, 25, 1))));
+
+  // A matrix may take the value of a smaller view of itself
+  m3 = m3.Block(10, 10, 2, 3);
+  EXPECT_EQ(2, m3.get_rows());
+  EXPECT_EQ((10 * 7 + 12) % 9 - 4, m3(0, 2));
+
+  // Or of a transposed view of itself, of the same size, which keeps the
+  // views of the matrix valid
+  int n = 5;
+  S21Matrix sq(n, n);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j) sq(i, j) = i * n + j;
+  S21Matrix expected = sq.Transpose();
+  S21MatrixView whole = sq;
+  sq = S21MatrixView(sq.data(), n, n, 1, n);
+  EXPECT_TRUE(sq == expected);
+  EXPECT_EQ(sq.data(), whole.data());
+  expected += expected.Transpose() * 2.0;
+  sq += 2.0 * S21MatrixView(sq.data(), n, n, 1, n);
+  EXPECT_TRUE(sq == expected);
+  // Row i of this one repeats sq(i, i)
+  S21MatrixView diagonal(sq.data(), n, n, n + 1, 0);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j) expected(i, j) -= sq(i, i);
+  sq -= diagonal;
+  EXPECT_TRUE(sq == expected);
+}
+
+TEST(Other, MemoryResourceTest) {
+  S21PoolResource pool;
+  {
+    S21ScopedResource scope(&pool);
+    S21Matrix m1(30, 30);
+    EXPECT_EQ(&pool, m1.get_resource());
+    double* data = &m1(0, 0);
+    m1(5, 5) = 1;
+    m1 = S21Matrix(20, 20);  // releases the 30x30 block to the pool
+    EXPECT_NE(data, &m1(0, 0));
+    S21Matrix m2(29, 31);  // falls into the same size class, block reused
+    EXPECT_EQ(data, &m2(0, 0));
+    EXPECT_EQ(0, m2(5, 5));
+  }
+  EXPECT_GT(pool.get_cached_bytes(), 0u);
+  pool.Trim();
+  EXPECT_EQ(0u, pool.get_cached_bytes());
+  EXPECT_EQ(std::pmr::get_default_resource(), S21Matrix().get_resource());
+
+  S21Matrix kept(4, 4, &pool);
+  for (int i = 0; i < 4; ++i) kept(i, i) = 2;
+  {
+    S21ArenaScope arena;
+    S21Matrix m4 = kept + kept * 2.0;
+    S21Matrix m5 = m4.Transpose() * kept;
+    EXPECT_EQ(arena.get_resource(), m5.get_resource());
+    EXPECT_EQ(12, m5(3, 3));
+    kept = m5;  // copies into the pool block kept already owns
+    EXPECT_EQ(&pool, kept.get_resource());
+    kept.set_cols(5);
+    EXPECT_EQ(&pool, kept.get_resource());
+  }
+  EXPECT_EQ(12, kept(2, 2));
+  EXPECT_EQ(0, kept(2, 4));
+
+  // Results that replace the block of an outer matrix inside an arena are
+  // allocated from the outer matrix's own resource
+  S21Matrix outer(4, 4), other(4, 6);
+  for (int i = 0; i < 4; ++i) {
+    outer(i, i) = 2;
+    other(i, i + 2) = 3;
+  }
+  {
+    S21ArenaScope arena;
+    outer.MulMatrix(other);
+    EXPECT_EQ(std::pmr::get_default_resource(), outer.get_resource());
+    S21Matrix wide = outer;
+    wide.set_cols(8);
+    wide = outer + outer;
+    EXPECT_EQ(arena.get_resource(), wide.get_resource());
+    kept = outer * 2.0;
+    EXPECT_EQ(&pool, kept.get_resource());
+  }
+  EXPECT_EQ(6, outer(0, 2));
+  EXPECT_EQ(0, outer(0, 0));
+  EXPECT_EQ(12, kept(3, 5));
+
+  // Moves from an arena matrix copy instead of taking its block
+  S21Matrix moved(2, 2), summed(2, 2);
+  {
+    S21ArenaScope arena;
+    S21Matrix tmp(4, 6), t2(4, 6);
+    tmp(1, 1) = 5;
+    t2(1, 1) = 7;
+    moved = std::move(tmp);
+    summed = std::move(t2) + outer;
+    EXPECT_EQ(std::pmr::get_default_resource(), moved.get_resource());
+    EXPECT_EQ(std::pmr::get_default_resource(), summed.get_resource());
+  }
+  EXPECT_EQ(5, moved(1, 1));
+  EXPECT_EQ(7, summed(1, 1));
+  EXPECT_EQ(6, summed(0, 2));
+}
+
+TEST(Other, MoveSemanticsTest) {
+  S21Matrix a(50, 40), b(50, 40), c(50, 40);
+  for (int i = 0; i < a.get_rows(); ++i)
+    for (int j = 0; j < a.get_cols(); ++j) {
+      a(i, j) = i + j;
+      b(i, j) = i - j;
+      c(i, j) = i * j;
+    }
+  S21Matrix expected = a + b + 2.0 * c;
+  S21Matrix a_copy(a);
+  double* data = &a_copy(0, 0);
+  S21Matrix r1 = (std::move(a_copy) + b) + c * 2.0;
+  EXPECT_EQ(data, &r1(0, 0));
+  EXPECT_EQ(0, a_copy.get_rows());
+  EXPECT_TRUE(r1 == expected);
+  S21Matrix r2 = b + (std::move(r1) - b);
+  EXPECT_EQ(data, &r2(0, 0));
+  EXPECT_TRUE(r2 == expected);
+
+  // Move assignment takes the block, copy assignment keeps its own one as
+  // long as the element count matches
+  S21Matrix r3(2, 2);
+  r3 = std::move(r2);
+  EXPECT_EQ(data, &r3(0, 0));
+  EXPECT_EQ(50, r3.get_rows());
+  S21Matrix r4(40, 50);
+  double* r4_data = &r4(0, 0);
+  r4 = r3;
+  EXPECT_EQ(r4_data, &r4(0, 0));
+  EXPECT_EQ(50, r4.get_rows());
+  EXPECT_TRUE(r4 == expected);
+  r4 = std::move(r4);
+  EXPECT_TRUE(r4 == expected);
+  r3 = std::move(r4) - std::move(r3);
+  EXPECT_EQ(r4_data, &r3(0, 0));
+  EXPECT_TRUE(r3 == S21Matrix(50, 40));
+  S21Matrix r5(3, 3);
+  r5 = std::move(r3) + c;
+  EXPECT_EQ(r4_data, &r5(0, 0));
+  EXPECT_TRUE(r5 == c);
+}
+
+TEST(Other, MatrixBatchTest) {
+  // 37 matrices fill two groups of lanes and part of a third one
+  const int count = 37, n = 5;
+  S21MatrixBatch a(count, n, n), b(count, n, 2);
+  for (int k = 0; k < count; ++k)
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j)
+        a(k, i, j) =
+            (k * 7 + i * 3 + j * j) % 11 - 5 + (i == j ? 20 + k % 9 : 0);
+      b(k, i, 0) = k - i;
+      b(k, i, 1) = 1;
+    }
+  EXPECT_EQ(count, a.get_count());
+  EXPECT_THROW(a(count, 0, 0), std::out_of_range);
+  S21SimdLevel detected = S21DetectSimdLevel();
+  for (int level = 0; level <= static_cast<int>(detected); ++level) {
+    S21SetSimdLevel(static_cast<S21SimdLevel>(level));
+    std::vector<double> det = a.Determinant();
+    S21MatrixBatch inv = a.Inverse();
+    S21MatrixBatch x = a.Solve(b);
+    S21MatrixBatch ab = a.Multiply(b);
+    ASSERT_EQ(count, static_cast<int>(det.size()));
+    for (int k = 0; k < count; ++k) {
+      S21Matrix m = a.Get(k);
+      EXPECT_NEAR(m.Determinant(), det[k], 1e-9 * std::abs(det[k]) + 1e-9);
+      EXPECT_TRUE(inv.Get(k) == m.InverseMatrix());
+      EXPECT_TRUE(x.Get(k) == Solve(m, b.Get(k)));
+      EXPECT_TRUE(ab.Get(k) == m * b.Get(k));
+    }
+  }
+  S21SetSimdLevel(detected);
+  EXPECT_THROW(b.Multiply(a), CustomException);
+  EXPECT_THROW(b.Determinant(), CustomException);
+
+  a.Set(20, S21Matrix(n, n));
+  EXPECT_THROW(a.Inverse(), CustomException);
+  EXPECT_THROW(a.Solve(b), CustomException);
+  EXPECT_EQ(0, a.Determinant()[20]);
+  S21MatrixBatchF f(3, 2, 2);
+  f(1, 0, 0) = 2;
+  f(1, 1, 1) = 4;
+  f(1, 0, 1) = 1;
+  EXPECT_FLOAT_EQ(8, f.Determinant()[1]);
+  EXPECT_FLOAT_EQ(0, f.Determinant()[2]);
+
+  // Assignments inside an arena scope keep the batch on its own resource
+  S21MatrixBatchF outer(1, 1, 1), moved(1, 1, 1);
+  {
+    S21ArenaScope arena;
+    S21MatrixBatchF tmp = f;
+    outer = tmp;
+    moved = std::move(tmp);
+  }
+  S21MatrixBatchF outer_copy = outer, moved_copy = moved;
+  EXPECT_EQ(3, outer_copy.get_count());
+  EXPECT_FLOAT_EQ(8, outer_copy.Determinant()[1]);
+  EXPECT_FLOAT_EQ(8, moved_copy.Determinant()[1]);
+}
+
+TEST(Other, SparseMatrixTest) {
+  // Every 7th element of a 60 x 45 matrix, plus a duplicate and a pair of
+  // triplets that cancel out
+  std::vector<S21Triplet<double>> triplets;
+  S21Matrix dense(60, 45);
+  for (int i = 0; i < 60; ++i)
+    for (int j = 0; j < 45; ++j)
+      if ((i * 45 + j) % 7 == 0) {
+        triplets.push_back({i, j, double(i - j)});
+        dense(i, j) = i - j;
+      }
+  triplets.push_back({59, 44, 1.5});
+  triplets.push_back({59, 44, 2.5});
+  triplets.push_back({0, 1, 3});
+  triplets.push_back({0, 1, -3});
+  dense(59, 44) += 4;
+  S21SparseMatrix csr(60, 45, triplets);
+  S21SparseMatrix csc(60, 45, triplets, S21SparseFormat::kCsc);
+  S21SparseMatrix from_dense(dense, S21SparseFormat::kCsc);
+  EXPECT_EQ(S21SparseFormat::kCsc, from_dense.get_format());
+  EXPECT_EQ(csr.get_nnz(), csc.get_nnz());
+  EXPECT_EQ(csr.get_nnz(), from_dense.get_nnz());
+  EXPECT_EQ(0, csr(0, 1));
+  EXPECT_EQ(4, csc(59, 44));
+  EXPECT_THROW(csr(60, 0), std::out_of_range);
+  EXPECT_TRUE(csr.ToDense() == dense);
+  EXPECT_TRUE(csc.ToDense() == dense);
+  EXPECT_TRUE(csc.ToFormat(S21SparseFormat::kCsr).ToDense() == dense);
+
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  std::size_t threshold = pool.get_serial_threshold();
+  pool.set_serial_threshold(16);
+  std::vector<double> x(45);
+  S21Matrix x_dense(45, 1), b(45, 3);
+  for (int j = 0; j < 45; ++j) {
+    x[j] = x_dense(j, 0) = j % 5 - 2;
+    for (int k = 0; k < 3; ++k) b(j, k) = j * k - 1;
+  }
+  S21Matrix y_dense = dense * x_dense, c_dense = dense * b;
+  for (const S21SparseMatrix* m : {&csr, &csc}) {
+    std::vector<double> y = *m * x;
+    for (int i = 0; i < 60; ++i) EXPECT_EQ(y_dense(i, 0), y[i]);
+    EXPECT_TRUE(*m * b == c_dense);
+  }
+  EXPECT_THROW(csr * std::vector<double>(44), CustomException);
+  EXPECT_THROW(csr * S21Matrix(60, 2), CustomException);
+
+  // Transposition only reinterprets the arrays
+  S21SparseMatrix t = csr.Transpose();
+  EXPECT_EQ(45, t.get_rows());
+  EXPECT_EQ(S21SparseFormat::kCsc, t.get_format());
+  EXPECT_TRUE(t.ToDense() == dense.Transpose());
+  t.TransposeInPlace();
+  EXPECT_TRUE(t.ToDense() == dense);
+
+  S21SparseMatrix sum = csr + csc;
+  EXPECT_EQ(S21SparseFormat::kCsr, sum.get_format());
+  EXPECT_TRUE(sum.ToDense() == dense * 2.0);
+  S21Matrix neg = dense * -1.0;
+  neg(3, 3) = 5;
+  S21SparseMatrix diff = csc + S21SparseMatrix(neg);
+  EXPECT_EQ(1u, diff.get_nnz());
+  EXPECT_EQ(5, diff(3, 3));
+  EXPECT_THROW(csr + t.Transpose(), CustomException);
+  pool.set_serial_threshold(threshold);
+}
+
+TEST(Other, MatrixFileTest) {
+  std::string path = ::testing::TempDir() + "s21_matrix_file_test.bin";
+  S21Matrix a(37, 23);
+  for (int i = 0; i < 37; ++i)
+    for (int j = 0; j < 23; ++j) a(i, j) = i * 0.5 - j;
+  S21SaveMatrix(path, a);
+  EXPECT_TRUE(S21LoadMatrix<double>(path) == a);
+  {
+    S21MappedMatrix mapped(path);
+    EXPECT_EQ(37, mapped.get_rows());
+    EXPECT_EQ(23, mapped.get_cols());
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(mapped.data()) % 64);
+    EXPECT_EQ(a(36, 22), mapped(36, 22));
+    EXPECT_THROW(mapped(37, 0), std::out_of_range);
+    S21Matrix doubled = mapped.View() + a;
+    EXPECT_TRUE(doubled == a * 2.0);
+    EXPECT_TRUE(S21Matrix::Multiply(mapped.View(), a.Transpose()) ==
+                a * a.Transpose());
+    // The view and its sub-views only read the mapping
+    static_assert(std::is_same<decltype(mapped.View()(0, 0)),
+                               const double&>::value,
+                  "A mapped matrix is read-only");
+    static_assert(std::is_same<decltype(mapped.View().Block(0, 0, 1, 1)),
+                               S21BasicMatrixView<const double>>::value,
+                  "A mapped matrix is read-only");
+    EXPECT_EQ(a(3, 4), mapped.View()(3, 4));
+  }
+  EXPECT_TRUE(S21LoadMatrix<double>(path) == a);
+
+  // A strided view is gathered row by row; a streaming writer gets the rows
+  // in pieces
+  S21SaveMatrix(path, a.Strided(0, 1, 12, 11, 3, 2));
+  S21Matrix strided = S21LoadMatrix<double>(path);
+  EXPECT_TRUE(strided == S21Matrix(a.Strided(0, 1, 12, 11, 3, 2)));
+  {
+    S21MatrixWriter writer(path, 37, 23);
+    writer.WriteRows(a.Block(0, 0, 10, 23));
+    writer.WriteRows(&a(10, 0), 27);
+    EXPECT_EQ(37, writer.get_rows_written());
+    EXPECT_THROW(writer.WriteRows(&a(0, 0), 1), CustomException);
+    writer.Close();
+  }
+  EXPECT_TRUE(S21LoadMatrix<double>(path) == a);
+  S21MatrixWriter incomplete(path, 37, 23);
+  incomplete.WriteRows(&a(0, 0), 5);
+  EXPECT_THROW(incomplete.Close(), CustomException);
+
+  S21BasicMatrix<std::complex<double>> c(3, 4);
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 4; ++j) c(i, j) = {double(i), double(-j)};
+  S21SaveMatrix(path, c);
+  EXPECT_TRUE(S21LoadMatrix<std::complex<double>>(path) == c);
+  EXPECT_THROW(S21LoadMatrix<double>(path), CustomException);
+  EXPECT_THROW(S21BasicMappedMatrix<float>{path}, CustomException);
+
+  // Truncated data and a foreign file
+  S21SaveMatrix(path, a);
+  std::FILE* file = std::fopen(path.c_str(), "r+b");
+  ASSERT_NE(nullptr, file);
+  EXPECT_EQ(0, ftruncate(fileno(file), 64 + 8 * 100));
+  std::fclose(file);
+  EXPECT_THROW(S21LoadMatrix<double>(path), CustomException);
+  EXPECT_THROW(S21MappedMatrix{path}, CustomException);
+  file = std::fopen(path.c_str(), "wb");
+  ASSERT_NE(nullptr, file);
+  std::fputs("not a matrix file at all, just some text", file);
+  std::fclose(file);
+  EXPECT_THROW(S21LoadMatrix<double>(path), CustomException);
+  EXPECT_THROW(S21LoadMatrix<double>(path + ".missing"), CustomException);
+  std::remove(path.c_str());
+}
+
+TEST(Other, MultiplyFilesTest) {
+  // A budget of 5 * 16 * 16 doubles gives 16 x 16 tiles with ragged edges
+  std::string a_path = ::testing::TempDir() + "s21_ooc_a.bin",
+              b_path = ::testing::TempDir() + "s21_ooc_b.bin",
+              c_path = ::testing::TempDir() + "s21_ooc_c.bin";
+  S21Matrix a(70, 45), b(45, 33);
+  for (int i = 0; i < 70; ++i)
+    for (int j = 0; j < 45; ++j) a(i, j) = (i * 3 + j * 7) % 13 - 6;
+  for (int i = 0; i < 45; ++i)
+    for (int j = 0; j < 33; ++j) b(i, j) = (i * 5 + j) % 9 - 4;
+  S21SaveMatrix(a_path, a);
+  S21SaveMatrix(b_path, b);
+  S21MultiplyFiles<double>(a_path, b_path, c_path, 5 * 16 * 16 * 8);
+  EXPECT_TRUE(S21LoadMatrix<double>(c_path) == a * b);
+  // A budget larger than the operands takes a single tile
+  S21MultiplyFiles<double>(a_path, b_path, c_path, std::size_t(1) << 30);
+  EXPECT_TRUE(S21LoadMatrix<double>(c_path) == a * b);
+
+  EXPECT_THROW(S21MultiplyFiles<double>(a_path, b_path, c_path, 8),
+               CustomException);
+  EXPECT_THROW(S21MultiplyFiles<double>(b_path, a_path, c_path, 1 << 20),
+               CustomException);
+  EXPECT_THROW(S21MultiplyFiles<float>(a_path, b_path, c_path, 1 << 20),
+               CustomException);
+  // The output may not be an operand, even under another name
+  S21Matrix square(45, 45);
+  S21SaveMatrix(c_path, square);
+  std::string link_path = ::testing::TempDir() + "s21_ooc_link.bin";
+  std::remove(link_path.c_str());
+  ASSERT_EQ(0, ::link(c_path.c_str(), link_path.c_str()));
+  EXPECT_THROW(S21MultiplyFiles<double>(c_path, c_path, c_path, 1 << 20),
+               CustomException);
+  EXPECT_THROW(S21MultiplyFiles<double>(a_path, c_path, link_path, 1 << 20),
+               CustomException);
+  EXPECT_TRUE(S21LoadMatrix<double>(link_path) == square);
+  std::remove(link_path.c_str());
+  std::remove(a_path.c_str());
+  std::remove(b_path.c_str());
+  std::remove(c_path.c_str());
+}
+
+TEST(Other, SolversTest) {
+  // Symmetric positive definite A = M^T * M + n * I and three right-hand
+  // sides
+  int n = 40;
+  S21Matrix m(n, n), x(n, 3);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) m(i, j) = (i * 7 + j * 3) % 11 - 5;
+    for (int k = 0; k < 3; ++k) x(i, k) = i % 4 - k;
+  }
+  S21Matrix a = m.Transpose() * m;
+  for (int i = 0; i < n; ++i) a(i, i) += n;
+  S21Matrix b = a * x;
+
+  S21Cholesky cholesky(a);
+  S21Matrix l = cholesky.L();
+  EXPECT_TRUE(l * l.Transpose() == a);
+  EXPECT_EQ(0, l(0, 1));
+  EXPECT_TRUE(cholesky.Solve(b) == x);
+  EXPECT_NEAR(1, cholesky.Determinant() / S21LU(a).Determinant(), 1e-9);
+  S21Matrix indefinite = a;
+  indefinite(5, 5) = -1;
+  EXPECT_THROW(S21Cholesky{indefinite}, CustomException);
+  EXPECT_THROW(S21Cholesky{S21Matrix(2, 3)}, CustomException);
+  EXPECT_THROW(cholesky.Solve(S21Matrix(3, 1)), CustomException);
+
+  // Least squares: the QR solution satisfies the normal equations
+  S21Matrix tall(n + 10, n - 5), rhs(n + 10, 2);
+  for (int i = 0; i < n + 10; ++i) {
+    for (int j = 0; j < n - 5; ++j) tall(i, j) = 1.0 / (i + j + 1) + (i == j);
+    rhs(i, 0) = i;
+    rhs(i, 1) = i % 3;
+  }
+  S21QR qr(tall);
+  S21Matrix q = qr.Q(), r = qr.R();
+  EXPECT_EQ(n + 10, q.get_rows());
+  EXPECT_EQ(n - 5, r.get_cols());
+  EXPECT_TRUE(q * r == tall);
+  S21Matrix qtq = q.Transpose() * q;
+  for (int i = 0; i < n - 5; ++i)
+    for (int j = 0; j < n - 5; ++j) EXPECT_NEAR(i == j, qtq(i, j), 1e-12);
+  EXPECT_EQ(0, r(3, 2));
+  S21Matrix ls = qr.Solve(rhs);
+  S21Matrix residual = tall * ls - rhs;
+  S21Matrix normal = tall.Transpose() * residual;
+  for (int i = 0; i < n - 5; ++i)
+    for (int k = 0; k < 2; ++k) EXPECT_NEAR(0, normal(i, k), 1e-8);
+  EXPECT_TRUE(S21QR(a).Solve(b) == x);
+  EXPECT_THROW(S21QR{S21Matrix(2, 3)}, CustomException);
+  S21Matrix rank_deficient(4, 2);
+  EXPECT_THROW(S21QR(rank_deficient).Solve(S21Matrix(4, 1)), CustomException);
+
+  using Complex = std::complex<double>;
+  S21BasicMatrix<Complex> c(6, 6), cx(6, 2);
+  for (int i = 0; i < 6; ++i) {
+    for (int j = 0; j < 6; ++j) c(i, j) = {double(i == j ? 9 : i - j), 1.0};
+    cx(i, 0) = {1.0, double(i)};
+    cx(i, 1) = {double(-i), 2.0};
+  }
+  S21BasicMatrix<Complex> cb = c * cx;
+  EXPECT_TRUE(S21BasicQR<Complex>(c).Solve(cb) == cx);
+  S21IterativeResult<Complex> complex_gmres = S21Gmres(c, cb);
+  EXPECT_TRUE(complex_gmres.converged);
+  EXPECT_TRUE(complex_gmres.x == cx);
+
+  // Iterative solvers on the dense SPD system and on a sparse
+  // non-symmetric one
+  S21IterativeResult<double> cg = S21ConjugateGradient(a, b);
+  EXPECT_TRUE(cg.converged);
+  EXPECT_LE(cg.residual, 1e-10);
+  EXPECT_TRUE(cg.x == x);
+  S21IterativeOptions few;
+  few.max_iterations = 2;
+  EXPECT_FALSE(S21ConjugateGradient(a, b, few).converged);
+  EXPECT_EQ(2, S21ConjugateGradient(a, b, few).iterations);
+  S21Matrix negative = a * -1.0;
+  EXPECT_THROW(S21ConjugateGradient(negative, b), CustomException);
+
+  std::vector<S21Triplet<double>> triplets;
+  int size = 300;
+  for (int i = 0; i < size; ++i) {
+    triplets.push_back({i, i, 4});
+    if (i > 0) triplets.push_back({i, i - 1, -1});
+    if (i + 1 < size) triplets.push_back({i, i + 1, -1.5});
+  }
+  S21SparseMatrix sparse(size, size, triplets);
+  S21Matrix sx(size, 2);
+  for (int i = 0; i < size; ++i) {
+    sx(i, 0) = i % 7;
+    sx(i, 1) = 1;
+  }
+  S21Matrix sb = sparse * sx;
+  S21IterativeOptions options;
+  options.restart = 20;
+  S21IterativeResult<double> gmres = S21Gmres(sparse, sb, options);
+  EXPECT_TRUE(gmres.converged);
+  EXPECT_TRUE(gmres.x == sx);
+  EXPECT_THROW(S21Gmres(sparse, S21Matrix(3, 1)), CustomException);
+  EXPECT_THROW(S21Gmres(S21Matrix(2, 3), S21Matrix(2, 1)), CustomException);
+}
+
+TEST(Other, InstrumentTest) {
+  // Counters only move when the library is built with INSTRUMENT=1
+  S21Instrument& instrument = S21Instrument::Instance();
+  instrument.Reset();
+  S21Matrix a(20, 20);
+  for (int i = 0; i < 20; ++i) a(i, i) = 2;
+  S21Matrix b(a);
+  b = a;
+  S21Matrix c = a * b;
+  c.MulMatrix(a);
+  a.Determinant();
+  a.InverseMatrix();
+  std::vector<S21OpStats> stats = instrument.Snapshot();
+  ASSERT_EQ(static_cast<std::size_t>(S21Op::kCount), stats.size());
+  const S21OpStats& mul = stats[static_cast<int>(S21Op::kMulMatrix)];
+  EXPECT_STREQ("MulMatrix", mul.name);
+  if (S21Instrument::IsCompiledIn()) {
+    EXPECT_EQ(2u, mul.calls);
+    EXPECT_EQ(2u * 2 * 20 * 20 * 20, mul.flops);
+    EXPECT_EQ(2u * 20 * 20 * sizeof(double), mul.bytes);
+    EXPECT_LE(mul.p50_ns, mul.p99_ns);
+    EXPECT_LE(mul.total_ns / 2, mul.p99_ns + mul.p99_ns / 4);
+    // b(a) allocates, b = a reuses the block, the two LU factorizations
+    // copy a
+    const S21OpStats& copy = stats[static_cast<int>(S21Op::kCopy)];
+    EXPECT_EQ(4u, copy.calls);
+    EXPECT_EQ(3u * 20 * 20 * sizeof(double), copy.bytes);
+    EXPECT_EQ(1u, stats[static_cast<int>(S21Op::kDeterminant)].calls);
+    EXPECT_EQ(1u, stats[static_cast<int>(S21Op::kInverseMatrix)].calls);
+    EXPECT_LE(1u, stats[static_cast<int>(S21Op::kConstruct)].calls);
+  } else {
+    for (const S21OpStats& s : stats) EXPECT_EQ(0u, s.calls);
+  }
+  std::string json = instrument.ToJson();
+  EXPECT_NE(std::string::npos,
+            json.find("{\"name\":\"MulMatrix\",\"calls\":"));
+  std::string text = instrument.ToPrometheus();
+  EXPECT_NE(std::string::npos,
+            text.find("# TYPE s21_matrix_calls_total counter\n"));
+  EXPECT_NE(std::string::npos,
+            text.find("s21_matrix_latency_seconds{op=\"Determinant\","
+                      "quantile=\"0.99\"}"));
+  instrument.Reset();
+  EXPECT_EQ(0u, instrument.Snapshot()[0].calls);
+
+  // perf events may be forbidden in a container, then they stay off
+  bool perf = instrument.EnablePerfEvents(true);
+  EXPECT_EQ(perf, instrument.get_perf_events());
+  instrument.EnablePerfEvents(false);
+  EXPECT_FALSE(instrument.get_perf_events());
+  EXPECT_EQ(0u, instrument.ReadCacheMisses());
+}
+
+TEST(Other, UncheckedAccessTest) {
+  S21Matrix m(3, 4);
+  const S21Matrix& cm = m;
+  static_assert(std::is_same<decltype(cm(0, 0)), const double&>::value,
+                "const operator() is read-only");
+  static_assert(std::is_same<decltype(cm[0]), const double*>::value,
+                "const rows are read-only");
+  static_assert(std::is_same<decltype(cm.begin()), const double*>::value,
+                "const iterators are read-only");
+  int k = 0;
+  for (double& x : m) x = k++;
+  EXPECT_EQ(6, m(1, 2));
+  EXPECT_EQ(m.data(), &m(0, 0));
+  EXPECT_EQ(m.RowData(2), &m(2, 0));
+  EXPECT_EQ(11, m[2][3]);
+  m[1][0] = -1;
+  EXPECT_EQ(-1, cm(1, 0));
+  EXPECT_EQ(12, cm.end() - cm.begin());
+  EXPECT_EQ(12, std::count_if(cm.cbegin(), cm.cend(),
+                              [](double x) { return x < 12; }));
+  std::fill(m.begin() + 4, m.begin() + 8, 7.0);
+  EXPECT_EQ(7, m(1, 3));
+  EXPECT_THROW(cm(3, 0), std::out_of_range);
+  EXPECT_THROW(m(0, -1), std::out_of_range);
+}
+
+TEST(Other, StrassenTest) {
+  // A tiny crossover makes the recursion go several levels deep; odd sizes
+  // exercise every peeling path
+  S21SetStrassenCrossover(8);
+  EXPECT_EQ(8, S21GetStrassenCrossover());
+  for (int n : {32, 37, 50}) {
+    S21Matrix a(n + 3, n), b(n, n + 1);
+    for (int i = 0; i < n + 3; ++i)
+      for (int j = 0; j < n; ++j) a(i, j) = (i * 7 + j * 3) % 11 - 5;
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n + 1; ++j) b(i, j) = (i * 5 + j) % 9 - 4;
+    S21Matrix classic = S21Matrix::Multiply(a, b, S21MulAlgorithm::kClassic);
+    S21Matrix fast = S21Matrix::Multiply(a, b, S21MulAlgorithm::kStrassen);
+    EXPECT_TRUE(fast == classic);
+    // kAuto switches to Strassen from twice the crossover
+    EXPECT_TRUE(S21Matrix::Multiply(a, b) == classic);
+    // Views with a row stride other than their width
+    EXPECT_TRUE(S21Matrix::Multiply(a.Block(1, 0, n, n), b.Block(0, 1, n, n),
+                                    S21MulAlgorithm::kStrassen) ==
+                S21Matrix::Multiply(a.Block(1, 0, n, n), b.Block(0, 1, n, n),
+                                    S21MulAlgorithm::kClassic));
+  }
+  S21BasicMatrix<std::complex<double>> c(40, 40);
+  for (int i = 0; i < 40; ++i)
+    for (int j = 0; j < 40; ++j) c(i, j) = {double(i - j), double(i % 3)};
+  EXPECT_TRUE(S21BasicMatrix<std::complex<double>>::Multiply(
+                  c, c, S21MulAlgorithm::kStrassen) ==
+              S21BasicMatrix<std::complex<double>>::Multiply(
+                  c, c, S21MulAlgorithm::kClassic));
+  // The workspace comes from the current resource and goes back to it
+  S21PoolResource pool;
+  {
+    S21ScopedResource scope(&pool);
+    S21Matrix a(40, 40);
+    S21Matrix classic = S21Matrix::Multiply(a, a, S21MulAlgorithm::kClassic);
+    EXPECT_EQ(0u, pool.get_cached_bytes());
+    S21Matrix fast = S21Matrix::Multiply(a, a, S21MulAlgorithm::kStrassen);
+    EXPECT_GT(pool.get_cached_bytes(), 0u);
+  }
+  S21SetStrassenCrossover(0);
+  EXPECT_LT(8, S21GetStrassenCrossover());
+}
+
+TEST(Other, MixedLUTest) {
+  // Well conditioned: the float factor plus refinement matches double LU
+  int n = 60;
+  S21Matrix a(n, n), b(n, 2);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) a(i, j) = 1.0 / (i + 2 * j + 1) + (i == j) * 3;
+    b(i, 0) = i % 7 - 3;
+    b(i, 1) = 1.0 / (i + 1);
+  }
+  S21MixedLU mixed(a);
+  S21Matrix x = mixed.Solve(b), expected = S21LU(a).Solve(b);
+  for (int i = 0; i < n; ++i)
+    for (int k = 0; k < 2; ++k) EXPECT_NEAR(expected(i, k), x(i, k), 1e-13);
+  S21Matrix product = mixed.Inverse() * a;
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j) EXPECT_NEAR(i == j, product(i, j), 1e-13);
+  EXPECT_FALSE(mixed.UsedFallback());
+
+  // Hilbert matrix: condition number ~1e13, far beyond float
+  int h = 10;
+  S21Matrix hilbert(h, h), ones(h, 1);
+  for (int i = 0; i < h; ++i) {
+    for (int j = 0; j < h; ++j) hilbert(i, j) = 1.0 / (i + j + 1);
+    ones(i, 0) = 1;
+  }
+  S21MixedLU ill(hilbert);
+  EXPECT_TRUE(ill.Solve(ones) == S21LU(hilbert).Solve(ones));
+  EXPECT_TRUE(ill.UsedFallback());
+
+  // The fallback may be made while another thread asks about it
+  S21MixedLU shared(hilbert);
+  std::thread solver([&] { shared.Solve(ones); });
+  while (!shared.UsedFallback()) std::this_thread::yield();
+  solver.join();
+
+  // Out of the float range
+  S21Matrix huge = a;
+  huge(0, 0) = 1e300;
+  S21MixedLU wide(huge);
+  EXPECT_TRUE(wide.Solve(b) == S21LU(huge).Solve(b));
+  EXPECT_TRUE(wide.UsedFallback());
+  EXPECT_THROW(S21MixedLU{S21Matrix(2, 3)}, CustomException);
+  EXPECT_THROW(mixed.Solve(S21Matrix(3, 1)), CustomException);
+}
+
+TEST(Other, AsyncTest) {
+  int n = 30;
+  S21Matrix a(n, n), b(n, n);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j) {
+      a(i, j) = 1.0 / (i + j + 1) + (i == j);
+      b(i, j) = (i * 5 + j) % 7 - 3;
+    }
+  S21Matrix a_copy = a, inverse = a_copy.InverseMatrix(), product = a * b;
+
+  // Two independent branches joined by a third task, the operands may be
+  // changed as soon as the calls return
+  S21Future<S21Matrix> inv = a.InverseMatrixAsync();
+  S21Future<S21Matrix> mul = a.MulMatrixAsync(b);
+  a.MulNumber(0);
+  S21Future<S21Matrix> sum = S21Async(
+      [](const S21Matrix& x, const S21Matrix& y) { return x + y; }, inv, mul);
+  S21Future<double> trace = sum.Then([n](const S21Matrix& m) {
+    double res = 0;
+    for (int i = 0; i < n; ++i) res += m(i, i);
+    return res;
+  });
+  S21Matrix expected = inverse + product;
+  EXPECT_TRUE(S21Matrix(sum.Get()) == expected);
+  double expected_trace = 0;
+  for (int i = 0; i < n; ++i) expected_trace += expected(i, i);
+  EXPECT_NEAR(expected_trace, trace.Get(), 1e-9);
+  EXPECT_TRUE(inv.IsReady());
+  EXPECT_NEAR(a_copy.Determinant(), a_copy.DeterminantAsync().Get(), 1e-12);
+
+  // Many independent tasks at once
+  std::vector<S21Future<double>> determinants;
+  for (int k = 0; k < 16; ++k)
+    determinants.push_back(a_copy.DeterminantAsync());
+  for (auto& d : determinants) EXPECT_EQ(determinants[0].Get(), d.Get());
+
+  // Errors surface in Get() of the failed task and of its dependents
+  S21Future<S21Matrix> singular = S21Matrix(3, 3).InverseMatrixAsync();
+  S21Future<int> rows =
+      singular.Then([](const S21Matrix& m) { return m.get_rows(); });
+  EXPECT_THROW(singular.Get(), CustomException);
+  EXPECT_THROW(rows.Get(), CustomException);
+  EXPECT_THROW(a.MulMatrixAsync(S21Matrix(2, 2)), CustomException);
+  EXPECT_THROW(S21Matrix(2, 3).InverseMatrixAsync(), CustomException);
+
+  S21Future<int> ready(7);
+  EXPECT_TRUE(ready.IsReady());
+  EXPECT_EQ(8, ready.Then([](int x) { return x + 1; }).Get());
+  S21Future<int> empty;
+  EXPECT_FALSE(empty.IsValid());
+  EXPECT_THROW(empty.IsReady(), CustomException);
+  EXPECT_THROW(empty.Wait(), CustomException);
+  EXPECT_THROW(empty.Get(), CustomException);
+  EXPECT_THROW(empty.Then([](int x) { return x; }), CustomException);
+}
+
+TEST(Other, MatrixGraphTest) {
+  int n = 12;
+  S21Matrix a(n, n), b(n, n);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j) {
+      a(i, j) = 1.0 / (i + j + 1) + (i == j);
+      b(i, j) = (i * 3 + j * 5) % 7 - 3;
+    }
+  S21Matrix at = a.Transpose(), bt = b.Transpose();
+
+  S21MatrixGraph graph;
+  S21LazyMatrix la = graph.Input(a), lb = graph.Input(b);
+  EXPECT_EQ(la.get_id(), graph.Input(a).get_id());
+  // Identical subexpressions share a node, sums in either order too
+  S21LazyMatrix p = la.Transpose() * lb;
+  EXPECT_EQ(p.get_id(), (la.Transpose() * lb).get_id());
+  EXPECT_EQ((la + lb).get_id(), (lb + la).get_id());
+  EXPECT_NE((la - lb).get_id(), (lb - la).get_id());
+  EXPECT_EQ(la.get_id(), la.Transpose().Transpose().get_id());
+  EXPECT_EQ(la.get_id(), (la * 1.0).get_id());
+  int nodes = graph.get_node_count();
+
+  // The transposes are fused: the product, the scale and the two sums are
+  // computed, b^T is only read through a view
+  S21LazyMatrix sum = p + lb.Transpose() * 2.0 + p;
+  EXPECT_EQ(nodes + 4, graph.get_node_count());
+  S21Matrix expected = at * b + bt * 2.0 + at * b;
+  EXPECT_TRUE(S21Matrix(sum.Evaluate()) == expected);
+  EXPECT_EQ(4, graph.get_computed_count());
+  sum.Evaluate();
+  EXPECT_EQ(4, graph.get_computed_count());
+
+  // The determinant and the inverse share one factorization
+  S21LazyMatrix c = la * lb + la;
+  S21Matrix c_value = a * b + a;
+  EXPECT_NEAR(c_value.Determinant(), c.Determinant(), 1e-6);
+  int computed = graph.get_computed_count();
+  EXPECT_TRUE(S21Matrix(c.InverseMatrix().Evaluate()) ==
+              c_value.InverseMatrix());
+  EXPECT_EQ(computed + 1, graph.get_computed_count());
+  EXPECT_NEAR(c.Determinant(), c.Transpose().Determinant(), 1e-12);
+  EXPECT_EQ(computed + 1, graph.get_computed_count());
+
+  // Changed inputs are picked up after Invalidate()
+  b(0, 0) += 1;
+  graph.Invalidate();
+  EXPECT_TRUE(S21Matrix(p.Evaluate()) == at * b);
+
+  EXPECT_THROW(la * graph.Input(S21Matrix(3, 2)), CustomException);
+  EXPECT_THROW(la + graph.Input(S21Matrix(3, 2)), CustomException);
+  S21Matrix rect(3, 2);
+  EXPECT_THROW(graph.Input(rect).InverseMatrix(), CustomException);
+  EXPECT_THROW(graph.Input(rect).Determinant(), CustomException);
+  S21Matrix zero(3, 3);
+  EXPECT_THROW(graph.Input(zero).InverseMatrix().Evaluate(), CustomException);
+
+  // Handles of another graph are rejected, and so is an input that changed
+  // its size after it was recorded
+  S21MatrixGraph other;
+  S21LazyMatrix foreign = other.Input(zero);
+  EXPECT_THROW(graph.Input(zero) + foreign, CustomException);
+  EXPECT_THROW(foreign * graph.Input(zero), CustomException);
+  S21Matrix resized(3, 3);
+  S21LazyMatrix lr = graph.Input(resized) * 2.0;
+  resized.set_rows(4);
+  graph.Invalidate();
+  EXPECT_THROW(lr.Evaluate(), CustomException);
+}
+
+TEST(Other, CachingTest) {
+  int n = 8;
+  S21Matrix m(n, n);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j) m(i, j) = 1.0 / (i + j + 1) + (i == j);
+  EXPECT_FALSE(m.get_caching());
+  m.set_caching(true);
+  EXPECT_TRUE(m.get_caching());
+  const S21Matrix& cm = m;
+  // Recomputed from an uncached copy
+  auto fresh_det = [&cm] { return S21Matrix(cm).Determinant(); };
+
+  double det = m.Determinant();
+  S21Matrix inverse = m.InverseMatrix();
+  EXPECT_EQ(det, m.Determinant());
+  EXPECT_TRUE(m.InverseMatrix() == inverse);
+  EXPECT_TRUE(m.CalcComplements() == S21Matrix(cm).CalcComplements());
+  EXPECT_EQ(cm(1, 1), 1.0 / 3 + 1);
+
+  // Taking a writable view drops the cache, but a write through a view
+  // taken earlier is not seen until the cache is dropped
+  S21MatrixView corner = m.Block(0, 0, 1, 1);
+  EXPECT_EQ(det, m.Determinant());
+  corner(0, 0) += 1;
+  EXPECT_EQ(det, m.Determinant());
+  m.InvalidateCache();
+  EXPECT_NE(det, m.Determinant());
+  EXPECT_DOUBLE_EQ(fresh_det(), m.Determinant());
+
+  // Every mutating path drops the cache
+  S21Matrix other = m;
+  std::vector<std::function<void()>> mutations = {
+      [&] { m(0, 1) += 1; },
+      [&] { m.data()[2] += 1; },
+      [&] { m[3][3] += 1; },
+      [&] { *m.begin() += 1; },
+      [&] { m.RowData(1)[0] -= 1; },
+      [&] { m.SumMatrix(other); },
+      [&] { m.SubMatrix(other * 0.5); },
+      [&] { m.MulNumber(2); },
+      [&] { m.MulMatrix(other); },
+      [&] { m.TransposeInPlace(); },
+      [&] { m.Row(2) *= 2.0; },
+      [&] { m += other * 2.0; },
+      [&] { m = other + other; },
+      [&] { m = other; },
+      [&] {
+        m.set_rows(n + 1);
+        m.set_cols(n + 1);
+        m(n, n) = 1;
+      },
+  };
+  for (auto& mutate : mutations) {
+    m.Determinant();
+    m.InverseMatrix();
+    mutate();
+    EXPECT_DOUBLE_EQ(fresh_det(), m.Determinant());
+    EXPECT_TRUE(m.InverseMatrix() == S21Matrix(cm).InverseMatrix());
+    EXPECT_TRUE(m.get_caching());
+  }
+
+  // Copies start uncached, moves keep the cache
+  S21Matrix copy = m;
+  EXPECT_FALSE(copy.get_caching());
+  S21Matrix moved = std::move(m);
+  EXPECT_TRUE(moved.get_caching());
+  moved.set_caching(false);
+  EXPECT_FALSE(moved.get_caching());
+  EXPECT_DOUBLE_EQ(copy.Determinant(), moved.Determinant());
+
+  // A cache filled inside an arena scope outlives the scope
+  S21Matrix outer = copy;
+  outer.set_caching(true);
+  double outer_det;
+  {
+    S21ArenaScope arena;
+    outer_det = outer.Determinant();
+    S21Matrix inverse = outer.InverseMatrix();
+    EXPECT_EQ(inverse.get_resource(), arena.get_resource());
+  }
+  EXPECT_EQ(outer_det, outer.Determinant());
+  EXPECT_TRUE(outer.InverseMatrix() == S21Matrix(copy).InverseMatrix());
+  EXPECT_EQ(outer.get_resource(), std::pmr::get_default_resource());
+
+  // Moving a cached matrix in from an arena copies it and leaves its cache
+  // behind
+  {
+    S21ArenaScope arena;
+    S21Matrix tmp = copy;
+    tmp.set_caching(true);
+    tmp.InverseMatrix();
+    outer = std::move(tmp);
+  }
+  EXPECT_TRUE(outer.get_caching());
+  EXPECT_TRUE(outer.InverseMatrix() == S21Matrix(copy).InverseMatrix());
+  EXPECT_EQ(outer.get_resource(), std::pmr::get_default_resource());
+}
+
+TEST(Other, SimdLevelsTest) {
+  // Every kernel set must give the same results, including ragged tails
+  S21SimdLevel detected = S21DetectSimdLevel();
+  for (int level = 0; level <= static_cast<int>(detected); ++level) {
+    S21SetSimdLevel(static_cast<S21SimdLevel>(level));
+    S21Matrix m1(7, 13), m2(7, 13);
+    for (int i = 0; i < m1.get_rows(); ++i)
+      for (int j = 0; j < m1.get_cols(); ++j) {
+        m1(i, j) = i * 13 + j;
+        m2(i, j) = 2 * (i * 13 + j);
+      }
+    S21Matrix m3(m1);
+    m3 += m2;
+    m3 -= m1;
+    EXPECT_TRUE(m3 == m2);
+    m3.MulNumber(0.5);
+    EXPECT_TRUE(m3 == m1);
+    m3(6, 12) += 1e-3;
+    EXPECT_FALSE(m3 == m1);
+    m3(6, 12) = m1(6, 12);
+    m3(0, 1) -= 1e-3;
+    EXPECT_FALSE(m3 == m1);
+
+    S21Matrix m4(70, 90), m5(90, 50);
+    for (int i = 0; i < m4.get_rows(); ++i)
+      for (int j = 0; j < m4.get_cols(); ++j) m4(i, j) = (i + 2 * j) % 9 - 4;
+    for (int i = 0; i < m5.get_rows(); ++i)
+      for (int j = 0; j < m5.get_cols(); ++j) m5(i, j) = (3 * i + j) % 5 - 2;
+    S21Matrix m6 = m4 * m5;
+    for (int i = 0; i < m6.get_rows(); ++i)
+      for (int j = 0; j < m6.get_cols(); ++j) {
+        double sum = 0;
+        for (int k = 0; k < m4.get_cols(); ++k) sum += m4(i, k) * m5(k, j);
+        EXPECT_DOUBLE_EQ(sum, m6(i, j));
+      }
+  }
+  EXPECT_EQ(detected, S21SetSimdLevel(S21SimdLevel::kAvx512));
+}
+
+TEST(Other, ThreadPoolTest) {
+  // Forces the parallel paths even on small inputs
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  int threads = pool.get_thread_count();
+  std::size_t threshold = pool.get_serial_threshold();
+  pool.set_thread_count(4);
+  pool.set_serial_threshold(64);
+  EXPECT_EQ(4, pool.get_thread_count());
+
+  S21Matrix m1(150, 150), m2(150, 150);
+  for (int i = 0; i < m1.get_rows(); ++i)
+    for (int j = 0; j < m1.get_cols(); ++j) {
+      m1(i, j) = i == j ? 150 : (i * 7 + j) % 13;
+      m2(i, j) = (i + j) % 5;
+    }
+  S21Matrix m3 = m1 * m2;
+  for (int i = 0; i < m3.get_rows(); i += 7)
+    for (int j = 0; j < m3.get_cols(); ++j) {
+      double sum = 0;
+      for (int k = 0; k < m1.get_cols(); ++k) sum += m1(i, k) * m2(k, j);
+      EXPECT_DOUBLE_EQ(sum, m3(i, j));
+    }
+  S21Matrix m4 = m1.Transpose();
+  for (int i = 0; i < m4.get_rows(); ++i)
+    for (int j = 0; j < m4.get_cols(); ++j) EXPECT_DOUBLE_EQ(m1(j, i), m4(i, j));
+  m4 = m1 + m2;
+  m4 -= m2;
+  EXPECT_TRUE(m4 == m1);
+  m4(149, 0) += 1;
+  EXPECT_FALSE(m4 == m1);
+  S21Matrix m5 = m1.InverseMatrix() * m1;
+  for (int i = 0; i < m5.get_rows(); ++i)
+    for (int j = 0; j < m5.get_cols(); ++j)
+      EXPECT_NEAR(i == j ? 1 : 0, m5(i, j), 1e-9);
+
+  std::atomic<int> sum(0);
+  pool.ParallelFor(1000, 1000, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) sum += i;
+  });
+  EXPECT_EQ(499500, sum);
+  ASSERT_ANY_THROW(pool.ParallelFor(
+      1000, 1000, [](std::size_t, std::size_t) { throw std::exception(); }));
+
+  pool.set_thread_count(threads);
+  pool.set_serial_threshold(threshold);
+}
+
+TEST(Other, ScalarTypesTest) {
+  S21SimdLevel detected = S21DetectSimdLevel();
+  for (int level = 0; level <= static_cast<int>(detected); ++level) {
+    S21SetSimdLevel(static_cast<S21SimdLevel>(level));
+    S21MatrixF m1(37, 41), m2(41, 19);
+    for (int i = 0; i < m1.get_rows(); ++i)
+      for (int j = 0; j < m1.get_cols(); ++j) m1(i, j) = (i + j) % 4 - 1.5f;
+    for (int i = 0; i < m2.get_rows(); ++i)
+      for (int j = 0; j < m2.get_cols(); ++j) m2(i, j) = (i * j) % 3 - 1;
+    S21MatrixF m3 = m1 * m2;
+    for (int i = 0; i < m3.get_rows(); ++i)
+      for (int j = 0; j < m3.get_cols(); ++j) {
+        float sum = 0;
+        for (int k = 0; k < m1.get_cols(); ++k) sum += m1(i, k) * m2(k, j);
+        EXPECT_FLOAT_EQ(sum, m3(i, j));
+      }
+    S21MatrixF m4 = m1 + m1 * 2.0f;
+    m4 -= 3 * m1;
+    EXPECT_TRUE(m4 == S21MatrixF(37, 41));
+    m4(36, 40) = 1;
+    EXPECT_FALSE(m4 == S21MatrixF(37, 41));
+  }
+  S21SetSimdLevel(detected);
+
+  S21MatrixLD m5(12, 12);
+  for (int i = 0; i < m5.get_rows(); ++i)
+    for (int j = 0; j < m5.get_cols(); ++j) m5(i, j) = i == j ? 2 : 1;
+  EXPECT_NEAR(13, static_cast<double>(m5.Determinant()), 1e-12);
+
+  // [[i, 1], [2, -i]] has determinant 1 - 2 = -1
+  S21MatrixC m6(2, 2);
+  m6(0, 0) = {0, 1};
+  m6(0, 1) = 1;
+  m6(1, 0) = 2;
+  m6(1, 1) = {0, -1};
+  EXPECT_NEAR(0, std::abs(m6.Determinant() + 1.0), 1e-12);
+  S21MatrixC m7 = m6 * m6.InverseMatrix();
+  EXPECT_TRUE(m7 == S21MatrixC(m7 * std::complex<double>(1)));
+  EXPECT_NEAR(1, std::abs(m7(0, 0)), 1e-12);
+  EXPECT_NEAR(0, std::abs(m7(0, 1)), 1e-12);
+  S21MatrixC m8(4, 4);
+  for (int i = 0; i < m8.get_rows(); ++i)
+    for (int j = 0; j < m8.get_cols(); ++j)
+      m8(i, j) = {static_cast<double>(i == j ? 4 : 1), static_cast<double>(j)};
+  S21MatrixC m9 = m8 * m8.CalcComplements().Transpose();
+  std::complex<double> det = m8.Determinant();
+  for (int i = 0; i < m9.get_rows(); ++i)
+    for (int j = 0; j < m9.get_cols(); ++j)
+      EXPECT_NEAR(0, std::abs(m9(i, j) - (i == j ? det : 0.0)), 1e-9);
+}
+
+TEST_F(S21MatrixTest, SolveTest) {
+  m1(1, 1) = -20;
+  S21Matrix x(3, 2);
+  for (int i = 0; i < x.get_rows(); ++i) {
+    x(i, 0) = i + 1;
+    x(i, 1) = -2 * i;
+  }
+  S21Matrix x1 = Solve(m1, m1 * x);
+  for (int i = 0; i < x.get_rows(); ++i)
+    for (int j = 0; j < x.get_cols(); ++j) EXPECT_NEAR(x(i, j), x1(i, j), 1e-9);
+
+  S21LU lu(m1);
+  EXPECT_NEAR(-92, lu.Determinant(), 1e-9);
+  ASSERT_ANY_THROW(lu.Solve(S21Matrix(2, 1)));
+  ASSERT_ANY_THROW(Solve(m2, x));
+  ASSERT_ANY_THROW(S21LU(S21Matrix(2, 3)));
+}
+
+TEST(Other, FixedMatrixTest) {
+  constexpr S21Matrix3 m1{1, 2, 3, 1, -20, 5, 1, 4, 7};
+  static_assert(m1.Determinant() == -92, "constexpr determinant");
+  static_assert(m1.At<1, 1>() == -20, "constexpr access");
+  constexpr S21Matrix3 m2 = m1.InverseMatrix();
+  EXPECT_DOUBLE_EQ(40. / 23, m2(0, 0));
+  EXPECT_DOUBLE_EQ(11. / 46, m2(2, 2));
+  EXPECT_TRUE(m1 * m2 == S21Matrix3({1, 0, 0, 0, 1, 0, 0, 0, 1}));
+  EXPECT_DOUBLE_EQ(-160, m1.CalcComplements()(0, 0));
+  ASSERT_ANY_THROW(m1(3, 0));
+  ASSERT_ANY_THROW(S21Matrix2().InverseMatrix());
+
+  S21FixedMatrix<2, 3> m3{1, 2, 3, 4, 5, 6};
+  S21FixedMatrix<3, 2> m4 = m3.Transpose();
+  S21Matrix2 m5 = m3 * m4;
+  EXPECT_TRUE(m5 == S21Matrix2({14, 32, 32, 77}));
+  m5 += m5 * 2 - 3 * m5;
+  EXPECT_TRUE(m5 == S21Matrix2());
+
+  S21FixedMatrix<5, 5> m6;
+  for (int i = 0; i < 5; ++i)
+    for (int j = 0; j < 5; ++j) m6(i, j) = i == j ? 2 : 1;
+  EXPECT_NEAR(6, m6.Determinant(), 1e-12);
+  S21FixedMatrix<5, 5> m9 = m6.InverseMatrix() * m6;
+  for (int i = 0; i < 5; ++i)
+    for (int j = 0; j < 5; ++j) EXPECT_NEAR(i == j ? 1 : 0, m9(i, j), 1e-12);
+
+  // Complex scalars go through the same pivoting and checks
+  using Complex = std::complex<double>;
+  S21FixedMatrix<5, 5, Complex> c6;
+  for (int i = 0; i < 5; ++i)
+    for (int j = 0; j < 5; ++j) c6(i, j) = i == j ? Complex(2, 1) : 1;
+  S21BasicMatrix<Complex> dynamic = c6;
+  EXPECT_NEAR(0, std::abs(dynamic.Determinant() - c6.Determinant()), 1e-12);
+  S21FixedMatrix<5, 5, Complex> identity;
+  for (int i = 0; i < 5; ++i) identity(i, i) = 1;
+  EXPECT_TRUE((c6.InverseMatrix() * c6).EqMatrix(identity));
+  EXPECT_FALSE(c6.EqMatrix(identity));
+
+  // Interoperability with the dynamic matrix
+  S21Matrix m7 = m1;
+  EXPECT_DOUBLE_EQ(-92, m7.Determinant());
+  S21Matrix m8 = m7 * m2;
+  EXPECT_TRUE(m8 == S21Matrix(S21Matrix3{1, 0, 0, 0, 1, 0, 0, 0, 1}));
+  EXPECT_TRUE(m1 + m7 == m7 * 2);
+  EXPECT_TRUE(m7 - m1 == S21Matrix(3, 3));
+  EXPECT_TRUE(S21Matrix3(m7) == m1);
+  ASSERT_ANY_THROW(S21Matrix2 m10(m7));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
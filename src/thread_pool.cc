@@ -0,0 +1,167 @@
+#include "s21_thread_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+
+namespace {
+
+// Index of the worker owned by the current thread, -1 outside the pool
+thread_local long current_worker = -1;
+
+struct LoopState {
+  // Shared by the caller and the helpers of one ParallelFor() call. Helpers
+  // that start after the loop is over only look at next and leave
+  std::atomic<std::size_t> next{0};
+  std::atomic<std::size_t> done{0};
+  std::size_t chunks = 0, n = 0;
+  const S21ThreadPool::RangeBody* body = nullptr;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::exception_ptr error;
+
+  void Run() {
+    for (std::size_t c = next++; c < chunks; c = next++) {
+      try {
+        (*body)(c * n / chunks, (c + 1) * n / chunks);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) error = std::current_exception();
+      }
+      if (++done == chunks) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_all();
+      }
+    }
+  }
+};
+
+}  // namespace
+
+S21ThreadPool& S21ThreadPool::Instance() {
+  static S21ThreadPool pool;
+  return pool;
+}
+
+S21ThreadPool::S21ThreadPool()
+    : thread_count_(1),
+      serial_threshold_(1 << 16),
+      next_queue_(0),
+      pending_(0),
+      stop_(false) {
+  const char* env = std::getenv("S21_MATRIX_THREADS");
+  Start(env ? std::atoi(env) : 0);
+}
+
+S21ThreadPool::~S21ThreadPool() { Stop(); }
+
+void S21ThreadPool::set_thread_count(int count) {
+  Stop();
+  Start(count);
+}
+
+void S21ThreadPool::Start(int count) {
+  // The calling thread always takes part in parallel loops, so count - 1
+  // workers are started
+  if (count <= 0) count = static_cast<int>(std::thread::hardware_concurrency());
+  if (count <= 0) count = 1;
+  thread_count_ = count;
+  stop_ = false;
+  for (int i = 0; i < count - 1; ++i)
+    workers_.push_back(std::make_unique<Worker>());
+  for (int i = 0; i < count - 1; ++i)
+    threads_.emplace_back(&S21ThreadPool::WorkerLoop, this, i);
+}
+
+void S21ThreadPool::Stop() {
+  // Workers finish the queued tasks before they exit
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  sleep_cv_.notify_all();
+  for (auto& thread : threads_) thread.join();
+  threads_.clear();
+  workers_.clear();
+  thread_count_ = 1;
+}
+
+void S21ThreadPool::Submit(Task task) {
+  // Without workers the task simply runs right away. A worker pushes to its
+  // own deque, other threads spread tasks round-robin
+  if (workers_.empty()) {
+    task();
+    return;
+  }
+  std::size_t index = current_worker >= 0
+                          ? static_cast<std::size_t>(current_worker)
+                          : next_queue_++ % workers_.size();
+  {
+    std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+    workers_[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    ++pending_;
+  }
+  sleep_cv_.notify_one();
+}
+
+bool S21ThreadPool::TryPop(std::size_t index, Task& task) {
+  // Own deque first (newest task, its data is likely still in cache), then
+  // steal the oldest task of somebody else
+  for (std::size_t i = 0; i < workers_.size(); ++i) {
+    Worker& worker = *workers_[(index + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) continue;
+    if (i == 0) {
+      task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+    } else {
+      task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+    }
+    --pending_;
+    return true;
+  }
+  return false;
+}
+
+void S21ThreadPool::WorkerLoop(std::size_t index) {
+  current_worker = static_cast<long>(index);
+  for (;;) {
+    Task task;
+    if (TryPop(index, task)) {
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    if (stop_ && pending_ == 0) break;
+    sleep_cv_.wait(lock, [this] { return stop_ || pending_ > 0; });
+  }
+}
+
+void S21ThreadPool::ParallelFor(std::size_t n, std::size_t work_per_item,
+                                const RangeBody& body) {
+  // Small loops and a single-threaded pool fall back to a plain call
+  if (n == 0) return;
+  std::size_t work = n * std::max<std::size_t>(work_per_item, 1);
+  std::size_t chunks = std::min({n, work / std::max<std::size_t>(
+                                               serial_threshold_, 1),
+                                 static_cast<std::size_t>(thread_count_) * 4});
+  if (thread_count_ == 1 || chunks < 2) {
+    body(0, n);
+    return;
+  }
+  auto state = std::make_shared<LoopState>();
+  state->chunks = chunks;
+  state->n = n;
+  state->body = &body;
+  std::size_t helpers =
+      std::min(chunks, static_cast<std::size_t>(thread_count_)) - 1;
+  for (std::size_t i = 0; i < helpers; ++i) Submit([state] { state->Run(); });
+  state->Run();
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->cv.wait(lock, [&] { return state->done == chunks; });
+  if (state->error) std::rethrow_exception(state->error);
+}
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <complex>
+#include <utility>
+#include <vector>
+
+#include "s21_kernels.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Blocks up to kLeaf x kLeaf elements are transposed directly: both the rows
+// read and the rows written stay in L1. The out-of-place copy splits rows
+// among threads in bands of kBand, the in-place one works on kTile tiles
+constexpr int kLeaf = 16;
+constexpr int kBand = 64;
+constexpr int kTile = 64;
+
+using Complex = std::complex<double>;
+
+template <typename T>
+void TransposeBlock(int rows, int cols, const T* src, std::ptrdiff_t lds,
+                    T* dst, std::ptrdiff_t ldd) {
+  // Cache-oblivious recursion: halves the longer side until the block is
+  // small, so at some level of the recursion it fits every cache level
+  // without knowing their sizes
+  if (rows <= kLeaf && cols <= kLeaf) {
+    for (int i = 0; i < rows; ++i)
+      for (int j = 0; j < cols; ++j) dst[j * ldd + i] = src[i * lds + j];
+  } else if (rows >= cols) {
+    int half = rows / 2;
+    TransposeBlock(half, cols, src, lds, dst, ldd);
+    TransposeBlock(rows - half, cols, src + half * lds, lds, dst + half, ldd);
+  } else {
+    int half = cols / 2;
+    TransposeBlock(rows, half, src, lds, dst, ldd);
+    TransposeBlock(rows, cols - half, src + half, lds, dst + half * ldd, ldd);
+  }
+}
+
+template <typename T>
+void SwapTransposeTile(int rows, int cols, T* a, T* b, std::ptrdiff_t ld) {
+  // Swaps the rows x cols tile a with the transpose of the cols x rows tile b
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j) std::swap(a[i * ld + j], b[j * ld + i]);
+}
+
+}  // namespace
+
+template <typename T>
+void S21Transpose(int rows, int cols, const T* src, std::ptrdiff_t lds,
+                  T* dst, std::ptrdiff_t ldd) {
+  // Bands of source rows go to different threads, each band is transposed
+  // recursively into the matching columns of dst
+  int bands = (rows + kBand - 1) / kBand;
+  S21ThreadPool::Instance().ParallelFor(
+      bands, static_cast<std::size_t>(kBand) * cols,
+      [&](std::size_t first, std::size_t last) {
+        int begin = static_cast<int>(first) * kBand;
+        int end = std::min(rows, static_cast<int>(last) * kBand);
+        TransposeBlock(end - begin, cols, src + begin * lds, lds, dst + begin,
+                       ldd);
+      });
+}
+
+template <typename T>
+void S21TransposeInPlace(int n, T* a, std::ptrdiff_t lda) {
+  // Square case: tile (bi, bj) is swapped with the transpose of tile (bj, bi)
+  // and diagonal tiles are transposed within themselves. Every tile row bi
+  // owns the pairs with bj >= bi, so threads never touch the same tile
+  int tiles = (n + kTile - 1) / kTile;
+  S21ThreadPool::Instance().ParallelFor(
+      tiles, static_cast<std::size_t>(kTile) * n / 2,
+      [&](std::size_t first, std::size_t last) {
+        for (int bi = first; bi < static_cast<int>(last); ++bi) {
+          int i0 = bi * kTile, ti = std::min(kTile, n - i0);
+          T* diag = a + i0 * lda + i0;
+          for (int i = 1; i < ti; ++i)
+            for (int j = 0; j < i; ++j)
+              std::swap(diag[i * lda + j], diag[j * lda + i]);
+          for (int j0 = i0 + kTile; j0 < n; j0 += kTile)
+            SwapTransposeTile(ti, std::min(kTile, n - j0), a + i0 * lda + j0,
+                              a + j0 * lda + i0, lda);
+        }
+      });
+}
+
+template <typename T>
+void S21TransposeInPlace(int rows, int cols, T* a) {
+  // Rectangular case of a contiguous rows x cols matrix. The element at flat
+  // index k of the result comes from index k * cols mod (size - 1) of the
+  // source; the permutation is applied cycle by cycle, and a bitmap (one bit
+  // per element) marks the indices already in place
+  if (rows == cols) {
+    S21TransposeInPlace(rows, a, cols);
+    return;
+  }
+  std::size_t last = static_cast<std::size_t>(rows) * cols - 1;
+  if (last < 2) return;
+  std::vector<bool> done(last + 1);
+  for (std::size_t start = 1; start < last; ++start) {
+    if (done[start]) continue;
+    // Walks the cycle backwards: each slot receives the element that
+    // belongs there, taken from the next slot of the cycle
+    std::size_t k = start;
+    T saved = a[start];
+    for (;;) {
+      std::size_t src = k * cols % last;
+      done[k] = true;
+      if (src == start) break;
+      a[k] = a[src];
+      k = src;
+    }
+    a[k] = saved;
+  }
+}
+
+template void S21Transpose(int, int, const float*, std::ptrdiff_t, float*,
+                           std::ptrdiff_t);
+template void S21Transpose(int, int, const double*, std::ptrdiff_t, double*,
+                           std::ptrdiff_t);
+template void S21Transpose(int, int, const long double*, std::ptrdiff_t,
+                           long double*, std::ptrdiff_t);
+template void S21Transpose(int, int, const Complex*, std::ptrdiff_t, Complex*,
+                           std::ptrdiff_t);
+template void S21TransposeInPlace(int, float*, std::ptrdiff_t);
+template void S21TransposeInPlace(int, double*, std::ptrdiff_t);
+template void S21TransposeInPlace(int, long double*, std::ptrdiff_t);
+template void S21TransposeInPlace(int, Complex*, std::ptrdiff_t);
+template void S21TransposeInPlace(int, int, float*);
+template void S21TransposeInPlace(int, int, double*);
+template void S21TransposeInPlace(int, int, long double*);
+template void S21TransposeInPlace(int, int, Complex*);